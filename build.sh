@@ -42,6 +42,21 @@ esac
 
 echo "Detected OS: $OS"
 
+if [[ "$1" == "-bench" ]]; then
+	echo "Compiling headless benchmark..."
+	mkdir -p ./build_release
+	clang++ -std=c++14 -O3 -pthread $SILENCED_WARNINGS ./src/bench_main.cpp -o ./build_release/bench_main -I./lib -I./lib/imgui
+	# NOTE: x86 builds default to SSE2, the AVX2 paths are checked by a second build on CPUs that can run it
+	if [[ "$(uname -m)" == "x86_64" ]]; then
+		clang++ -std=c++14 -O3 -mavx2 -pthread $SILENCED_WARNINGS ./src/bench_main.cpp -o ./build_release/bench_main_avx2 -I./lib -I./lib/imgui
+		if grep -q avx2 /proc/cpuinfo 2>/dev/null || sysctl -n machdep.cpu.leaf7_features 2>/dev/null | grep -q AVX2; then
+			./build_release/bench_main_avx2 -checks || exit 1
+		fi
+	fi
+	./build_release/bench_main $2
+	exit $?
+fi
+
 if [[ "$1" == "-release" || "$1" == "-mac" ]]; then
     echo "Compiling in release mode..."
 	DEBUG_GAME_DEPENDENCIES=""
@@ -103,7 +118,7 @@ elif [[ "$OS" == "$LINUX" ]]; then
 
 	GLAD_CLANG_CMD="clang++ -x c ./lib/glad/src/glad.c -o ./lib/linux/glad.o -c -I./lib/glad/include"
 
-	PLATFORM_CLANG_CMD="clang++ -std=c++14 $SILENCED_WARNINGS $FLAGS ./src/platform_main.cpp $DEBUG_PLAT_DEPENDENCIES -o $BUILD_DIR/platform_main -L$BUILD_DIR -lSDL3 -Wl,-rpath,@loader_path -I./lib/glad/include -I./lib -I./lib/imgui -I./lib/imgui/backends $LINUX_LIB_DIR/glad.o"
+	PLATFORM_CLANG_CMD="clang++ -std=c++14 $SILENCED_WARNINGS $FLAGS -pthread ./src/platform_main.cpp $DEBUG_PLAT_DEPENDENCIES -o $BUILD_DIR/platform_main -L$BUILD_DIR -lSDL3 -Wl,-rpath,@loader_path -I./lib/glad/include -I./lib -I./lib/imgui -I./lib/imgui/backends $LINUX_LIB_DIR/glad.o"
 
 	LIB_DIR=$LINUX_LIB_DIR;
 	
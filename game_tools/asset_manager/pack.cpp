@@ -552,7 +552,7 @@ int main(int argc, char* argv[]) {
     }
 
     //~~~~~~~~~~~~~~ Sprite Table ~~~~~~~~~~~~~~~~~~~~~~//
-    const char* sprite_table_declaration = "Sprite sprite_table[SPRITE_COUNT] = {\n";
+    const char* sprite_table_declaration = "const Sprite sprite_table[SPRITE_COUNT] = {\n";
     fwrite(sprite_table_declaration, w_str_len(sprite_table_declaration), sizeof(char), file);
 
     for (int i = 0; i < bitmap_count; i++) {
@@ -584,7 +584,7 @@ int main(int argc, char* argv[]) {
 
     //~~~~~~~~~~~~~~ Hitbox Table ~~~~~~~~~~~~~~~~~~//
 
-    const char* hitbox_table_declaration = "Rect hitbox_table[SPRITE_COUNT] = {\n";
+    const char* hitbox_table_declaration = "const Rect hitbox_table[SPRITE_COUNT] = {\n";
     fwrite(hitbox_table_declaration, w_str_len(hitbox_table_declaration), sizeof(char), file);
 
     for (int i = 0; i < anim_count; i++) {
@@ -626,7 +626,7 @@ int main(int argc, char* argv[]) {
 
     //~~~~~~~~~~~~~~~~~~~ Write Animation Table ~~~~~~~~~~~~~~~~~~~~~//
 
-    const char* anim_table_definition = "Animation animation_table[ANIM_COUNT] = {\n";
+    const char* anim_table_definition = "const Animation animation_table[ANIM_COUNT] = {\n";
     fwrite(anim_table_definition, w_str_len(anim_table_definition), sizeof(char), file);
 
     for (int i = 0; i < anim_count; i++) {
@@ -3,7 +3,7 @@
 
 #include "waffle_lib.h"
 
-Sprite sprite_table[SPRITE_COUNT] = {
+const Sprite sprite_table[SPRITE_COUNT] = {
     [SPRITE_BOAR_MEAT_RAW] = {845, 131, 8, 8, false, {0.00, 0.00}},
     [SPRITE_GUN_GREEN] = {548, 149, 12, 3, false, {0.00, 0.00}},
     [SPRITE_ROBOTICS_FACTORY] = {1, 1, 118, 118, false, {0.00, 0.00}},
@@ -358,11 +358,11 @@ Sprite sprite_table[SPRITE_COUNT] = {
     [SPRITE_WARRIOR_MOVE_LEFT_3] = {439, 59, 14, 19, true, {6.00, 16.00}},
 };
 
-Rect hitbox_table[SPRITE_COUNT] = {
+const Rect hitbox_table[SPRITE_COUNT] = {
     [SPRITE_WARRIOR_ATTACK_2] = {0, 8, 18, 20},
 };
 
-Animation animation_table[ANIM_COUNT] = {
+const Animation animation_table[ANIM_COUNT] = {
     [ANIM_BOAR_IDLE] = {.frames = {{SPRITE_BOAR_IDLE_0, 75},  {SPRITE_BOAR_IDLE_1, 75},  {SPRITE_BOAR_IDLE_2, 75},
                                    {SPRITE_BOAR_IDLE_3, 75},  {SPRITE_BOAR_IDLE_4, 75},  {SPRITE_BOAR_IDLE_5, 75},
                                    {SPRITE_BOAR_IDLE_6, 75},  {SPRITE_BOAR_IDLE_7, 75},  {SPRITE_BOAR_IDLE_8, 75},
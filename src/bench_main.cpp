@@ -0,0 +1,610 @@
+// Headless benchmark of the sim tick and entity render of game_update_and_render. Build and run with ./build.sh -bench,
+// an optional first argument overrides the number of ticks per scene. Self checks run first, the benchmark exits with 1
+// when one of them fails.
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+#include "game_main.cpp"
+#include "job_system.cpp"
+
+#define BENCH_DEFAULT_TICKS 600
+#define BENCH_WARMUP_TICKS 60
+#define BENCH_SEED 0x5eed1234
+#define BENCH_SIM_DT_S (1.0 / 60.0)
+#define BENCH_PROJECTILE_SPEED 30.0f
+#define BENCH_WORLD_HALF_EXTENT (DEFAULT_WORLD_WIDTH / 2.0f)
+#define BENCH_SCALING_ENTITY_COUNT 50000
+#define BENCH_LOD_FOCUS_POSITION ((Vec2){-96, 96}) // middle of the top left spawn chunk, a player in a corner
+
+static Jobs bench_jobs;
+
+struct BenchReservation {
+    void* address;
+    uint64 size;
+};
+
+// NOTE: the entity store's arrays plus the two collision rule slot arrays
+static BenchReservation bench_reservations[ENTITY_STORE_MAX_ARRAYS + 2];
+static uint32 bench_reservation_count = 0;
+
+// Stand ins for the platform layer's reserve and commit, reservations are released at the end of each run
+static RESERVE_MEMORY(bench_reserve_memory) {
+    ASSERT(bench_reservation_count < ArraySize(bench_reservations), "too many benchmark reservations");
+
+    void* result = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (result == MAP_FAILED) {
+        return NULL;
+    }
+
+    bench_reservations[bench_reservation_count++] = {.address = result, .size = size};
+
+    return result;
+}
+
+static COMMIT_MEMORY(bench_commit_memory) {
+    return mprotect(address, size, PROT_READ | PROT_WRITE) == 0;
+}
+
+static void bench_release_memory() {
+    for (int i = 0; i < bench_reservation_count; i++) {
+        munmap(bench_reservations[i].address, bench_reservations[i].size);
+    }
+    bench_reservation_count = 0;
+}
+
+struct BenchResult {
+    uint32 entity_count;
+    uint32 ticks;
+    double elapsed_ns;
+    uint64 pairs_tested;
+    uint64 broadphase_candidates;
+    uint64 attack_hitboxes;
+    uint64 entities_stepped;
+    uint64 cache_misses; // UINT64_MAX when the counter isn't available
+    CollisionStats last_tick_stats;
+    uint32 rules_peak;
+    uint32 store_capacity;
+    long long frame_arena_used;
+};
+
+static GET_PERFORMANCE_COUNTER(bench_now_ns) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64)ts.tv_sec * 1000000000ull + (uint64)ts.tv_nsec;
+}
+
+// Opens a hardware counter of last level cache misses for this thread, returns -1 where there is none, e.g. on macOS
+// or when perf_event_paranoid doesn't allow it
+static int bench_cache_miss_counter_open() {
+#ifdef __linux__
+    struct perf_event_attr attr = {};
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    return -1;
+#endif
+}
+
+static uint64 bench_cache_miss_counter_read(int counter) {
+    uint64 count = UINT64_MAX;
+#ifdef __linux__
+    if (counter >= 0 && read(counter, &count, sizeof(count)) != sizeof(count)) {
+        count = UINT64_MAX;
+    }
+#endif
+
+    return count;
+}
+
+static uint64 bench_peak_rss_bytes() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    return usage.ru_maxrss * 1024ull;
+#endif
+}
+
+static Vec2 bench_random_position(uint32* rng) {
+    return {w_rng_range_f32(rng, -BENCH_WORLD_HALF_EXTENT, BENCH_WORLD_HALF_EXTENT),
+            w_rng_range_f32(rng, -BENCH_WORLD_HALF_EXTENT, BENCH_WORLD_HALF_EXTENT)};
+}
+
+static Vec2 bench_random_direction(uint32* rng) {
+    float rads = w_rng_range_f32(rng, 0, 2 * M_PI);
+    return w_vec_unit_from_radians(rads);
+}
+
+// What the benchmark keeps of its scene between ticks, the player and command center are looked up by id again
+// before every tick since the flush and the reorder move entities
+struct BenchScene {
+    uint32 rng;
+    uint32 player_id;
+    uint32 command_center_id;
+    uint32 projectile_count;
+    PlayerInput input;
+};
+
+static void bench_fire_projectile(GameState* game_state, Entity* projectile, uint32* rng) {
+    remove_collision_rules(projectile->id, game_state);
+
+    entity_teleport(projectile, bench_random_position(rng), projectile->z_pos);
+    projectile->velocity = w_vec_mult(bench_random_direction(rng), BENCH_PROJECTILE_SPEED);
+    projectile->distance_traveled = 0;
+}
+
+// Replaces the projectiles the last tick destroyed, so the entity count stays about the same for every tick
+static void bench_refill_projectiles(GameState* game_state, BenchScene* scene) {
+    while (entity_type_count(ENTITY_TYPE_PROJECTILE) < scene->projectile_count) {
+        Entity* projectile = entity_find(entity_create_projectile(bench_random_position(&scene->rng), 0, {}));
+        if (!projectile) {
+            break;
+        }
+        bench_fire_projectile(game_state, projectile, &scene->rng);
+    }
+}
+
+// Seeded layout of 40% boars, 20% warriors, 30% blocks and 10% projectiles spread over the default world, plus the
+// player at BENCH_LOD_FOCUS_POSITION and a command center next to it. The chunk spawn states are left empty, so proc
+// gen adds nothing while the benchmark runs.
+static void bench_setup_scene(GameState* game_state, BenchScene* scene, uint32 entity_count) {
+    // NOTE: nothing dies or starves, so apart from the projectiles the entity count stays the same for every tick
+    game_state->tools.disable_hunger = true;
+
+    Entity* player = entity_find(entity_create(ENTITY_TYPE_PLAYER, BENCH_LOD_FOCUS_POSITION));
+    player->hp = UINT32_MAX / 2;
+    scene->player_id = player->id;
+
+    Vec2 command_center_position = w_vec_add(BENCH_LOD_FOCUS_POSITION, {6, -6});
+    scene->command_center_id = entity_find(entity_create(ENTITY_TYPE_LANDING_POD_YELLOW, command_center_position))->id;
+
+    scene->input = {};
+    scene->input.world.aim_vec = {1, 0};
+
+    for (int i = 0; i < entity_count; i++) {
+        uint32 roll = w_rng_range_i32(&scene->rng, 0, 9);
+        Vec2 position = bench_random_position(&scene->rng);
+
+        if (roll < 4) {
+            Entity* boar = entity_find(entity_create(ENTITY_TYPE_BOAR, position));
+            boar->hp = UINT32_MAX / 2;
+            entity_cold(boar)->damage_since_spawn = -1e30f;
+        } else if (roll < 6) {
+            Entity* warrior = entity_find(entity_create(ENTITY_TYPE_WARRIOR, position));
+            warrior->hp = UINT32_MAX / 2;
+        } else if (roll < 9) {
+            entity_create(ENTITY_TYPE_BLOCK, position);
+        } else {
+            Entity* projectile = entity_find(entity_create_projectile(position, 0, {}));
+            bench_fire_projectile(game_state, projectile, &scene->rng);
+            scene->projectile_count++;
+        }
+    }
+}
+
+// One frame of game_update_and_render without a window or input: the real sim tick followed by the entity render,
+// both through the job system. Returns the frame arena bytes the frame used.
+static long long bench_tick(GameState* game_state, BenchScene* scene) {
+    game_state->frame_arena.next = game_state->frame_arena.data;
+    job_system_begin_frame();
+    entity_dirty_clear();
+
+    game_state->player = entity_from_id(scene->player_id);
+    game_state->command_center = entity_from_id(scene->command_center_id);
+
+    RenderGroup main_render_group = {};
+    main_render_group.id = RENDER_GROUP_ID_MAIN;
+    main_render_group.size = game_state->entity_data.store.capacity * 2;
+    main_render_group.quads =
+        (RenderQuad*)w_arena_alloc(&game_state->frame_arena, main_render_group.size * sizeof(RenderQuad));
+
+    game_sim_tick(game_state, &scene->input);
+    render_entities(game_state, &main_render_group, 1.0f);
+
+    return game_state->frame_arena.next - game_state->frame_arena.data;
+}
+
+// Entities whose chunk stepped in the last tick
+static uint32 bench_count_stepped(GameState* game_state) {
+    uint32 stepped = 0;
+    for (int i = 0; i < game_state->entity_data.entity_count; i++) {
+        if (sim_lod_dt_s(&game_state->sim_lod, game_state->entity_data.entities[i].position) > 0) {
+            stepped++;
+        }
+    }
+
+    return stepped;
+}
+
+// An empty game state with thread_count job threads, released again with bench_game_state_destroy
+static GameState* bench_game_state_create(uint32 thread_count) {
+    job_system_init(&bench_jobs, thread_count);
+    g_jobs = &bench_jobs;
+    g_sim_dt_s = BENCH_SIM_DT_S;
+    g_get_performance_counter = bench_now_ns;
+    g_performance_frequency = 1000000000ull;
+
+    long long memory_size = sizeof(GameState) + Megabytes(32);
+    void* memory = calloc(1, memory_size);
+    ASSERT(memory, "failed to allocate benchmark memory");
+
+    GameState* game_state = (GameState*)memory;
+    game_state->main_arena.size = memory_size - sizeof(GameState);
+    game_state->main_arena.data = (char*)memory + sizeof(GameState);
+    game_state->main_arena.next = game_state->main_arena.data;
+
+    game_state->attack_id_next = ATTACK_ID_START;
+    game_state->brain_scheduler.think_budget = BRAIN_THINK_BUDGET;
+    entity_init(&game_state->entity_data);
+    init_entity_data(game_state, bench_reserve_memory, bench_commit_memory);
+
+    return game_state;
+}
+
+static void bench_game_state_destroy(GameState* game_state) {
+    bench_release_memory();
+    free(game_state);
+    job_system_shutdown();
+}
+
+// With reorder the store is sorted spatially once the scene is spawned and then as the game does it. Without it the
+// store stays in creation order, which for the random layout is the scattered order a long session drifts towards.
+// thread_count is the number of job threads the brains, the broadphase gather and the entity render are spread
+// across. Only the frames are timed, refilling the projectiles and counting the stepped entities are not.
+static BenchResult bench_run(uint32 entity_count, uint32 ticks, bool reorder, uint32 thread_count, bool lod) {
+    GameState* game_state = bench_game_state_create(thread_count);
+    game_state->tools.disable_entity_reorder = !reorder;
+    game_state->tools.disable_sim_lod = !lod;
+
+    BenchScene scene = {.rng = BENCH_SEED};
+    bench_setup_scene(game_state, &scene, entity_count);
+    if (reorder) {
+        entity_reorder_spatially();
+    }
+
+    for (int i = 0; i < BENCH_WARMUP_TICKS; i++) {
+        bench_tick(game_state, &scene);
+        bench_refill_projectiles(game_state, &scene);
+    }
+
+    BenchResult result = {};
+    result.entity_count = game_state->entity_data.entity_count;
+    result.ticks = ticks;
+
+    int cache_miss_counter = bench_cache_miss_counter_open();
+#ifdef __linux__
+    if (cache_miss_counter >= 0) {
+        ioctl(cache_miss_counter, PERF_EVENT_IOC_RESET, 0);
+        ioctl(cache_miss_counter, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+
+    for (int i = 0; i < ticks; i++) {
+        uint64 start_ns = bench_now_ns();
+        result.frame_arena_used = bench_tick(game_state, &scene);
+        result.elapsed_ns += (double)(bench_now_ns() - start_ns);
+
+        result.pairs_tested += game_state->collision_stats.pairs_tested;
+        result.broadphase_candidates += game_state->collision_stats.broadphase_candidates;
+        result.attack_hitboxes += game_state->collision_stats.attack_hitboxes;
+        result.entities_stepped += bench_count_stepped(game_state);
+
+        bench_refill_projectiles(game_state, &scene);
+    }
+
+    result.cache_misses = bench_cache_miss_counter_read(cache_miss_counter);
+    if (cache_miss_counter >= 0) {
+        close(cache_miss_counter);
+    }
+
+    result.last_tick_stats = game_state->collision_stats;
+    result.rules_peak = game_state->collision_rules.stats.peak;
+    result.store_capacity = game_state->entity_data.store.capacity;
+
+    bench_game_state_destroy(game_state);
+
+    return result;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~ self checks ~~~~~~~~~~~~~~~~~~~~~~~~ //
+
+// NOTE: the benchmark is built without DEBUG, so the checks count their failures instead of using ASSERT and a failed
+// check fails the run
+static uint32 bench_check_failures = 0;
+
+static void bench_check(bool passed, const char* explain) {
+    if (!passed) {
+        printf("Check failed: %s\n", explain);
+        bench_check_failures++;
+    }
+}
+
+// Runs every mutating helper on a fresh warrior and chest and checks each one marked the bit it is responsible for.
+// Runs on an empty store, the entities it makes are freed again and the dirty set is left empty.
+static void bench_check_dirty_tracking(GameState* game_state) {
+    EntityData* entity_data = &game_state->entity_data;
+
+    Entity* warrior = entity_spawn(ENTITY_TYPE_WARRIOR, {0, 0}, 0);
+    Entity* chest = entity_spawn(ENTITY_TYPE_CHEST_IRON, {4, 0}, 0);
+    if (!warrior || !chest) {
+        bench_check(false, "the dirty tracking entities couldn't be spawned");
+        return;
+    }
+
+    uint32 warrior_id = warrior->id;
+    EntityHandle warrior_handle = entity_to_handle(warrior);
+    uint32 chest_id = chest->id;
+    EntityHandle chest_handle = entity_to_handle(chest);
+    bench_check(entity_dirty_bits(warrior) == ENTITY_DIRTY_ALL && entity_dirty_bits(chest) == ENTITY_DIRTY_ALL,
+                "spawning should mark every dirty bit");
+    bench_check(entity_data->dirty.count == 2, "each dirty entity should be listed once");
+
+    entity_dirty_clear();
+    warrior = entity_from_id(warrior_id);
+    chest = entity_from_id(chest_id);
+    bench_check(entity_dirty_bits(warrior) == 0 && entity_data->dirty.count == 0,
+                "entity_dirty_clear left bits set");
+
+    warrior->position = {1, 1};
+    entity_spatial_update(warrior);
+    bench_check(entity_dirty_bits(warrior) == ENTITY_DIRTY_TRANSFORM,
+                "entity_spatial_update should mark TRANSFORM");
+
+    entity_spatial_update(warrior);
+    bench_check(entity_data->dirty.count == 1, "marking an entity twice should list it once");
+    entity_dirty_clear();
+
+    AnimationID move = entity_info[ENTITY_TYPE_WARRIOR].animations.move;
+    entity_play_animation(warrior, move);
+    bench_check(entity_dirty_bits(warrior) == ENTITY_DIRTY_VISUAL, "changing the animation should mark VISUAL");
+    entity_dirty_clear();
+
+    entity_play_animation(warrior, move);
+    bench_check(entity_dirty_bits(warrior) == 0, "replaying the same animation should not mark VISUAL");
+
+    entity_deal_damage(warrior, 0, game_state);
+    bench_check(entity_dirty_bits(warrior) == ENTITY_DIRTY_VISUAL, "entity_deal_damage should mark VISUAL");
+    entity_dirty_clear();
+
+    Inventory* chest_inventory = entity_inventory(chest);
+    inventory_add_item(chest_inventory, ENTITY_TYPE_IRON, 2);
+    bench_check(entity_dirty_bits(chest) == ENTITY_DIRTY_INVENTORY,
+                "inventory_add_item should mark the owner INVENTORY");
+    entity_dirty_clear();
+
+    inventory_remove_items(chest_inventory, ENTITY_TYPE_IRON, 2);
+    bench_check(entity_dirty_bits(chest) == ENTITY_DIRTY_INVENTORY,
+                "removing items should mark the owner INVENTORY");
+    entity_dirty_clear();
+
+    entity_command_set_flags(warrior, ENTITY_F_NONSPACIAL, 0);
+    bench_check(entity_dirty_bits(warrior) == ENTITY_DIRTY_LIFECYCLE,
+                "entity_command_set_flags should mark LIFECYCLE");
+    entity_dirty_clear();
+
+    entity_mark_for_deletion(warrior);
+    bench_check(entity_dirty_bits(warrior) == ENTITY_DIRTY_LIFECYCLE,
+                "entity_mark_for_deletion should mark LIFECYCLE");
+    entity_dirty_clear();
+
+    // NOTE: freed here rather than by a flush, the pending destroy is skipped at the first flush as its handle is stale
+    entity_free(warrior_id);
+    entity_free(chest_id);
+    bench_check(entity_data->dirty.bits[warrior_id] == ENTITY_DIRTY_LIFECYCLE &&
+                    entity_data->dirty.bits[chest_id] == ENTITY_DIRTY_LIFECYCLE,
+                "entity_free should mark LIFECYCLE");
+    bench_check(!entity_find(warrior_handle) && !entity_find(chest_handle),
+                "the dirty tracking entities were not freed");
+
+    entity_dirty_clear();
+}
+
+// Fills the rule table past 3/4 so it grows, then checks every rule is still found, that removing rules shifts the
+// rest of their probe chains back, and that lookups follow a chain that wraps around the end of the table.
+static void bench_check_collision_rules(GameState* game_state) {
+    CollisionRules* rules = &game_state->collision_rules;
+    uint32 first_slot_count = rules->slot_count;
+
+    // NOTE: pairs of ids below 100 with ids from 100, every id has its own rule list in the entity store
+    uint32 pair_count = (first_slot_count / 4) * 3 + 64;
+    for (uint32 i = 0; i < pair_count; i++) {
+        add_collision_rule(1 + i % 99, 100 + i / 99, (i % 2) == 0, game_state);
+    }
+    bench_check(rules->slot_count == first_slot_count * 2, "the rule table didn't double past 3/4 full");
+    bench_check(rules->stats.live == pair_count, "rules were dropped while the table grew");
+
+    bool all_found = true;
+    for (uint32 i = 0; i < pair_count; i++) {
+        CollisionRule* rule = find_collision_rule(100 + i / 99, 1 + i % 99, rules);
+        all_found = all_found && rule && rule->should_collide == ((i % 2) == 0);
+    }
+    bench_check(all_found, "a rule wasn't found after the table grew");
+
+    for (uint32 id = 1; id < 100; id += 2) {
+        remove_collision_rules(id, game_state);
+    }
+
+    bool removed_correctly = true;
+    for (uint32 i = 0; i < pair_count; i++) {
+        uint32 a_id = 1 + i % 99;
+        bool found = find_collision_rule(a_id, 100 + i / 99, rules) != NULL;
+        removed_correctly = removed_correctly && found == ((a_id % 2) == 0);
+    }
+    bench_check(removed_correctly, "removing rules lost others in their probe chains or left removed ones behind");
+
+    for (uint32 id = 2; id < 100; id += 2) {
+        remove_collision_rules(id, game_state);
+    }
+    bench_check(rules->stats.live == 0, "rules are left after removing all of them");
+
+    // NOTE: three rules between distinct ids that hash to the last slot fill it and the first two, the first is
+    // removed so the others have to shift back across the end of the table
+    uint32 last_slot = rules->slot_count - 1;
+    uint32 capacity = game_state->entity_data.store.capacity;
+    uint32 wrap_a_ids[3];
+    uint32 wrap_b_ids[3];
+    uint32 wrap_count = 0;
+    uint32 next_a_id = 1;
+    while (wrap_count < ArraySize(wrap_a_ids) && next_a_id < capacity / 2) {
+        uint32 a_id = next_a_id++;
+        for (uint32 b_id = capacity / 2; b_id < capacity; b_id++) {
+            if (collision_rule_home_slot(rules, a_id, b_id) == last_slot) {
+                wrap_a_ids[wrap_count] = a_id;
+                wrap_b_ids[wrap_count] = b_id;
+                wrap_count++;
+                break;
+            }
+        }
+    }
+    bench_check(wrap_count == ArraySize(wrap_a_ids), "not enough id pairs hash to the last rule slot");
+    if (wrap_count < ArraySize(wrap_a_ids)) {
+        return;
+    }
+
+    for (int i = 0; i < ArraySize(wrap_a_ids); i++) {
+        add_collision_rule(wrap_a_ids[i], wrap_b_ids[i], false, game_state);
+    }
+    bench_check(rules->slots[last_slot] && rules->slots[0] && rules->slots[1],
+                "the probe chain didn't wrap around the end of the table");
+
+    remove_collision_rules(wrap_a_ids[0], game_state);
+    bench_check(!find_collision_rule(wrap_a_ids[0], wrap_b_ids[0], rules) &&
+                    find_collision_rule(wrap_a_ids[1], wrap_b_ids[1], rules) &&
+                    find_collision_rule(wrap_a_ids[2], wrap_b_ids[2], rules),
+                "lookups failed after removing from a wrapped probe chain");
+    bench_check(rules->slots[last_slot] && rules->slots[0] && !rules->slots[1],
+                "the wrapped probe chain wasn't shifted back");
+
+    remove_collision_rules(wrap_a_ids[1], game_state);
+    remove_collision_rules(wrap_a_ids[2], game_state);
+    bench_check(rules->stats.live == 0, "the wrapped rules weren't removed");
+}
+
+// Runs every self check on its own game state, returns false when one of them failed
+static bool bench_run_checks() {
+    printf("Running self checks, collision batch built for %s\n", W_SIMD_NAME);
+    bench_check(w_check_aabb_collision_batch(), "w_aabb_collision_batch doesn't match w_rect_collision");
+
+    GameState* game_state = bench_game_state_create(1);
+    bench_check_dirty_tracking(game_state);
+    bench_check_collision_rules(game_state);
+    bench_game_state_destroy(game_state);
+
+    return bench_check_failures == 0;
+}
+
+// Pass -checks to only run the self checks
+int main(int argc, char** argv) {
+    bool checks_only = argc > 1 && strcmp(argv[1], "-checks") == 0;
+    uint32 ticks = BENCH_DEFAULT_TICKS;
+    if (argc > 1 && !checks_only) {
+        ticks = (uint32)atoi(argv[1]);
+    }
+    ASSERT(ticks > 0, "tick count must be positive");
+
+    w_init_animation(animation_table);
+
+    if (!bench_run_checks()) {
+        printf("%u self checks failed\n", bench_check_failures);
+        return 1;
+    }
+    if (checks_only) {
+        return 0;
+    }
+
+    // NOTE: the entity store grows as the scene is spawned, the larger scenes are past the old fixed size of 10000
+    uint32 entity_counts[] = {1000, 5000, 10000, 50000};
+
+    printf("%u ticks per scene (+%u warmup), dt %.4f s, GameState %.1f MB\n", ticks, BENCH_WARMUP_TICKS,
+           BENCH_SIM_DT_S, sizeof(GameState) / (1024.0 * 1024.0));
+    // NOTE: the movement loop walks every hot record once per tick, before the split it walked the whole record
+    printf("Entity %zu B hot + %zu B cold, %zu B per record before the hot/cold split\n", sizeof(Entity),
+           sizeof(EntityCold), sizeof(Entity) + sizeof(EntityCold));
+    // NOTE: misses/tick are last level cache misses over the measured ticks, "n/a" when the counter can't be opened
+    printf("%8s %8s %9s %12s %10s %12s %12s %10s %8s %8s %10s %10s %10s %10s %12s %12s\n", "entities", "order",
+           "capacity", "ns/ent/tick", "ms/tick", "pairs/tick", "cands/tick", "hitboxes", "awake", "asleep",
+           "rule_peak", "frame_kb", "hot_kb", "unsplit_kb", "misses/tick", "peak_rss_mb");
+
+    for (int i = 0; i < ArraySize(entity_counts); i++) {
+        for (int reorder = 0; reorder < 2; reorder++) {
+            BenchResult result = bench_run(entity_counts[i], ticks, reorder, 1, false);
+
+            double ns_per_tick = result.elapsed_ns / result.ticks;
+            double hot_kb = result.entity_count * sizeof(Entity) / 1024.0;
+            double unsplit_kb = result.entity_count * (sizeof(Entity) + sizeof(EntityCold)) / 1024.0;
+            char misses_per_tick[32] = "n/a";
+            if (result.cache_misses != UINT64_MAX) {
+                snprintf(misses_per_tick, sizeof(misses_per_tick), "%.1f",
+                         (double)result.cache_misses / result.ticks);
+            }
+
+            printf("%8u %8s %9u %12.1f %10.3f %12.1f %12.1f %10.1f %8u %8u %10u %10.1f %10.1f %10.1f %12s %12.1f\n",
+                   result.entity_count, reorder ? "morton" : "created", result.store_capacity,
+                   ns_per_tick / result.entity_count, ns_per_tick / 1000000.0,
+                   (double)result.pairs_tested / result.ticks, (double)result.broadphase_candidates / result.ticks,
+                   (double)result.attack_hitboxes / result.ticks, result.last_tick_stats.bodies_awake,
+                   result.last_tick_stats.bodies_asleep, result.rules_peak, result.frame_arena_used / 1024.0, hot_kb,
+                   unsplit_kb, misses_per_tick, bench_peak_rss_bytes() / (1024.0 * 1024.0));
+        }
+    }
+
+    // NOTE: the table above runs on one job thread since the miss counter only sees the main thread
+    uint32 max_threads = (uint32)w_clamp_between(sysconf(_SC_NPROCESSORS_ONLN), 1, JOB_MAX_THREADS);
+    printf("\nThread scaling of %u entities in morton order, up to %u threads\n", BENCH_SCALING_ENTITY_COUNT,
+           max_threads);
+    printf("%8s %10s %10s %12s\n", "threads", "ms/tick", "speedup", "cands/tick");
+
+    // NOTE: doubles the thread count each row, the last row is the full count even when it isn't a power of two
+    double single_thread_ns_per_tick = 0;
+    for (uint32 thread_count = 1;; thread_count = (uint32)w_min(thread_count * 2, max_threads)) {
+        BenchResult result = bench_run(BENCH_SCALING_ENTITY_COUNT, ticks, true, thread_count, false);
+
+        double ns_per_tick = result.elapsed_ns / result.ticks;
+        if (thread_count == 1) {
+            single_thread_ns_per_tick = ns_per_tick;
+        }
+
+        printf("%8u %10.3f %9.2fx %12.1f\n", thread_count, ns_per_tick / 1000000.0,
+               single_thread_ns_per_tick / ns_per_tick, (double)result.broadphase_candidates / result.ticks);
+
+        if (thread_count == max_threads) {
+            break;
+        }
+    }
+
+    // NOTE: with the focus in a corner chunk of the 4x4 spawn chunks 4 are near, 5 mid and 7 far
+    printf("\nSim LOD of %u entities in morton order on one thread, player at (%.0f, %.0f)\n",
+           BENCH_SCALING_ENTITY_COUNT, BENCH_LOD_FOCUS_POSITION.x, BENCH_LOD_FOCUS_POSITION.y);
+    printf("%8s %10s %10s %14s %12s %12s\n", "lod", "ms/tick", "speedup", "stepped/tick", "pairs/tick",
+           "cands/tick");
+
+    double lod_off_ns_per_tick = 0;
+    for (int lod = 0; lod < 2; lod++) {
+        BenchResult result = bench_run(BENCH_SCALING_ENTITY_COUNT, ticks, true, 1, lod);
+
+        double ns_per_tick = result.elapsed_ns / result.ticks;
+        if (!lod) {
+            lod_off_ns_per_tick = ns_per_tick;
+        }
+
+        printf("%8s %10.3f %9.2fx %14.1f %12.1f %12.1f\n", lod ? "tiers" : "off", ns_per_tick / 1000000.0,
+               lod_off_ns_per_tick / ns_per_tick, (double)result.entities_stepped / result.ticks,
+               (double)result.pairs_tested / result.ticks, (double)result.broadphase_candidates / result.ticks);
+    }
+
+    return 0;
+}
@@ -1,29 +1,44 @@
 void brain_move_towards_target(Entity* entity, float velocity_mag) {
     EntityAnimations animations = entity_info[entity->type].animations;
 
-    Vec2 direction = w_vec_norm(w_vec_sub(entity->brain.target_position, entity->position));
+    Brain* brain = &entity_cold(entity)->brain;
+    Vec2 direction = w_vec_norm(w_vec_sub(brain->target_position, entity->position));
     entity->velocity = w_vec_mult(direction, velocity_mag);
     entity->facing_direction = w_vec_norm(entity->velocity);
-    entity_play_animation_with_direction(animations.move, &entity->anim_state, entity->facing_direction);
+    brain->steer_speed = velocity_mag;
+    entity_wake(entity);
+    entity_play_animation_with_direction(entity, animations.move);
+}
+
+// Between thinks a brain that is moving keeps heading for the target_position its last think picked
+static void brain_steer(Entity* entity) {
+    Brain* brain = &entity_cold(entity)->brain;
+    if (brain->steer_speed == 0 || (entity->velocity.x == 0 && entity->velocity.y == 0)) {
+        return;
+    }
+
+    Vec2 direction = w_vec_norm(w_vec_sub(brain->target_position, entity->position));
+    entity->velocity = w_vec_mult(direction, brain->steer_speed);
+    entity->facing_direction = w_vec_norm(entity->velocity);
 }
 
 void brain_idle(Entity* entity) {
-    Brain* brain = &entity->brain;
+    Brain* brain = &entity_cold(entity)->brain;
     EntityAnimations animations = entity_info[entity->type].animations;
     if (brain->cooldown_s <= 0) {
-        brain->target_position = random_point_near_position(entity->position, 5, 5);
+        brain->target_position = random_point_near_position(entity->position, 5, 5, &brain->rng);
         brain->cooldown_s = 10;
         brain->ai_state = AI_STATE_WANDER;
     }
     entity->velocity = {0, 0};
-    entity_play_animation_with_direction(animations.idle, &entity->anim_state, entity->facing_direction);
+    entity_play_animation_with_direction(entity, animations.idle);
 }
 
 void brain_wander(Entity* entity) {
-    Brain* brain = &entity->brain;
+    Brain* brain = &entity_cold(entity)->brain;
     if (w_euclid_dist(entity->position, brain->target_position) <= 1.0f || brain->cooldown_s <= 0) {
         brain->ai_state = AI_STATE_IDLE;
-        brain->cooldown_s = w_random_between(1, 6);
+        brain->cooldown_s = w_rng_range_f32(&brain->rng, 1, 6);
     }
 
     brain_move_towards_target(entity, 1.0f);
@@ -36,12 +51,12 @@ void brain_dead(Entity* entity) {
     set(entity->flags, ENTITY_F_NONSPACIAL);
     set(entity->flags, ENTITY_F_DELETE_AFTER_ANIMATION);
     if (animations.death != ANIM_UNKNOWN) {
-        entity_play_animation_with_direction(animations.death, &entity->anim_state, entity->facing_direction);
+        entity_play_animation_with_direction(entity, animations.death);
     }
 }
 
 void brain_update_player(Entity* entity, GameState* game_state, PlayerInput* player_input, float dt_s) {
-    Brain* brain = &entity->brain;
+    Brain* brain = &entity_cold(entity)->brain;
 
     if (entity->hp > 0) {
         brain->ai_state = AI_STATE_PLAYER_CONTROLLED;
@@ -62,12 +77,12 @@ void brain_update_player(Entity* entity, GameState* game_state, PlayerInput* pla
         entity->velocity = {0, 0};
         EntityAnimations animations = entity_info[entity->type].animations;
         set(entity->flags, ENTITY_F_NONSPACIAL);
-        w_play_animation(animations.death, &entity->anim_state);
-        if (w_animation_complete(&entity->anim_state, g_sim_dt_s)) {
+        entity_play_animation(entity, animations.death);
+        if (w_animation_complete(&entity->anim_state, dt_s)) {
             entity->hp = MAX_HP_PLAYER;
-            entity->hunger = MAX_HUNGER_PLAYER;
-            entity->position = {0, 0};
+            entity_cold(entity)->hunger = MAX_HUNGER_PLAYER;
             unset(entity->flags, ENTITY_F_NONSPACIAL);
+            entity_teleport(entity, {0, 0}, entity->z_pos);
         }
         break;
     }
@@ -77,8 +92,8 @@ void brain_update_player(Entity* entity, GameState* game_state, PlayerInput* pla
 };
 
 void brain_update_warrior(Entity* entity, GameState* game_state, float dt_s) {
-    Brain* brain = &entity->brain;
-    Entity* player = game_state->player;
+    Brain* brain = &entity_cold(entity)->brain;
+    EntitySnapshot* player = entity_snapshot(game_state->player->id);
     float distance_to_player = w_euclid_dist(entity->position, player->position);
     if (distance_to_player < 5 && brain->ai_state != AI_STATE_ATTACK && brain->ai_state != AI_STATE_DEAD) {
         brain->ai_state = AI_STATE_CHASE;
@@ -96,7 +111,7 @@ void brain_update_warrior(Entity* entity, GameState* game_state, float dt_s) {
     case AI_STATE_CHASE:
         if (distance_to_player >= 5) {
             brain->ai_state = AI_STATE_IDLE;
-            brain->cooldown_s = w_random_between(1, 6);
+            brain->cooldown_s = w_rng_range_f32(&brain->rng, 1, 6);
         } else if (distance_to_player < 0.5) {
             brain->ai_state = AI_STATE_ATTACK;
         } else {
@@ -104,7 +119,7 @@ void brain_update_warrior(Entity* entity, GameState* game_state, float dt_s) {
             brain_move_towards_target(entity, 5.0f);
         }
         entity->facing_direction = w_vec_norm(entity->velocity);
-        entity_play_animation_with_direction(animations.move, &entity->anim_state, entity->facing_direction);
+        entity_play_animation_with_direction(entity, animations.move);
         break;
     case AI_STATE_ATTACK: {
         entity->velocity = {0, 0};
@@ -113,16 +128,14 @@ void brain_update_warrior(Entity* entity, GameState* game_state, float dt_s) {
         } else {
             entity->facing_direction.x = 1;
         }
-        entity_play_animation_with_direction(animations.attack, &entity->anim_state, entity->facing_direction);
+        entity_play_animation_with_direction(entity, animations.attack);
         if (entity->attack_id == 0) {
-            entity->attack_id = get_next_attack_id(&game_state->attack_id_next);
+            set(brain->intents, BRAIN_INTENT_F_ATTACK_START);
         }
         if (w_animation_complete(&entity->anim_state, dt_s)) {
-            entity->attack_id = 0;
-            remove_collision_rules(entity->attack_id, game_state->collision_rule_hash,
-                                   &game_state->collision_rule_free_list);
+            set(brain->intents, BRAIN_INTENT_F_ATTACK_END);
             brain->ai_state = AI_STATE_CHASE;
-            brain->cooldown_s = w_random_between(1, 6);
+            brain->cooldown_s = w_rng_range_f32(&brain->rng, 1, 6);
         }
         break;
     }
@@ -135,7 +148,7 @@ void brain_update_warrior(Entity* entity, GameState* game_state, float dt_s) {
 }
 
 void brain_update_boar(Entity* entity, GameState* game_state, float dt_s) {
-    Brain* brain = &entity->brain;
+    Brain* brain = &entity_cold(entity)->brain;
     switch (brain->ai_state) {
     case AI_STATE_IDLE:
         brain_idle(entity);
@@ -153,7 +166,7 @@ void brain_update_boar(Entity* entity, GameState* game_state, float dt_s) {
 }
 
 void brain_update_robot_gatherer(Entity* entity, GameState* game_state, double dt_s) {
-    Brain* brain = &entity->brain;
+    Brain* brain = &entity_cold(entity)->brain;
     switch (brain->ai_state) {
     case AI_STATE_IDLE:
         brain_idle(entity);
@@ -225,18 +238,11 @@ void brain_update_robot_gatherer(Entity* entity, GameState* game_state, double d
 
         brain_move_towards_target(entity, 4.0f);
 
-        float min_corn_distance = vision_radius;
-        for (int i = 0; i < game_state->entity_data.entity_count; i++) {
-            Entity* ent = &game_state->entity_data.entities[i];
-
-            if (ent->type == ENTITY_TYPE_PLANT_CORN) {
-                float distance_from_robot = w_euclid_dist(entity->position, ent->position);
-                if (distance_from_robot < min_corn_distance) {
-                    min_corn_distance = distance_from_robot;
-                    brain->target_handle = entity_to_handle(ent);
-                    brain->ai_state = AI_STATE_HARVESTING;
-                }
-            }
+        uint32 corn_id;
+        if (entity_snapshot_query_nearest(entity->position, vision_radius, {.type = ENTITY_TYPE_PLANT_CORN}, 1,
+                                          &corn_id)) {
+            brain->target_handle = entity_to_handle(entity_from_id(corn_id));
+            brain->ai_state = AI_STATE_HARVESTING;
         }
 
         break;
@@ -244,18 +250,19 @@ void brain_update_robot_gatherer(Entity* entity, GameState* game_state, double d
     case AI_STATE_HARVESTING: {
         Entity* target = entity_find(brain->target_handle);
 
-        brain->harvesting_cooldown_s = w_clamp_min(brain->harvesting_cooldown_s - g_sim_dt_s, 0);
+        brain->harvesting_cooldown_s = w_clamp_min(brain->harvesting_cooldown_s - dt_s, 0);
 
         if (target) {
-            float distance_to_target = w_euclid_dist(entity->position, target->position);
+            Vec2 target_position = entity_snapshot(target->id)->position;
+            float distance_to_target = w_euclid_dist(entity->position, target_position);
             if (distance_to_target < 0.5) {
                 entity->velocity = {0, 0};
                 if (brain->harvesting_cooldown_s <= 0) {
-                    entity_deal_damage(target, 1, game_state);
+                    set(brain->intents, BRAIN_INTENT_F_HARVEST);
                     brain->harvesting_cooldown_s = BRAIN_HARVESTING_COOLDOWN_S;
                 }
             } else {
-                brain->target_position = target->position;
+                brain->target_position = target_position;
                 brain_move_towards_target(entity, 4.0f);
             }
         } else {
@@ -270,24 +277,240 @@ void brain_update_robot_gatherer(Entity* entity, GameState* game_state, double d
     }
 }
 
-void brain_update(Entity* entity, GameState* game_state, PlayerInput* player_input, double dt_s) {
-    Brain* brain = &entity->brain;
+static void brain_cooldown_update(Entity* entity, double dt_s) {
+    Brain* brain = &entity_cold(entity)->brain;
     brain->cooldown_s = w_clamp_min(brain->cooldown_s - dt_s, 0);
+}
 
-    switch (brain->type) {
+// ~~~~~~~~~~~~~~~~~~~~~~~~ scheduler ~~~~~~~~~~~~~~~~~~~~~~~~ //
+
+static float brain_think_interval_s(BrainType type) {
+    switch (type) {
     case BRAIN_TYPE_WARRIOR:
-        brain_update_warrior(entity, game_state, dt_s);
-        break;
+        return 0.1f;
     case BRAIN_TYPE_BOAR:
-        brain_update_boar(entity, game_state, dt_s);
-        break;
     case BRAIN_TYPE_ROBOT_GATHERER:
-        brain_update_robot_gatherer(entity, game_state, dt_s);
-        break;
-    case BRAIN_TYPE_PLAYER:
-        brain_update_player(entity, game_state, player_input, dt_s);
-        break;
+        return 0.25f;
     default:
-        break;
+        return 0;
+    }
+}
+
+// NOTE: an attack ends on the tick its animation does and a death has to start its animation right away
+static bool brain_thinks_every_tick(Brain* brain) {
+    return brain->ai_state == AI_STATE_ATTACK || brain->ai_state == AI_STATE_DEAD;
+}
+
+// Flags the brains of a bucket that think this tick, walking it round robin from where the last tick ran out of
+// budget. Brains whose sim LOD chunk doesn't step this tick don't build up think time. Returns the number of thinks.
+static uint32 brain_schedule_bucket(GameState* game_state, BrainType type, uint32* thinks_left) {
+    BrainScheduler* scheduler = &game_state->brain_scheduler;
+    BrainBucket* bucket = &game_state->entity_data.brain_buckets.buckets[type];
+    if (bucket->count == 0) {
+        return 0;
     }
+
+    float interval_s = brain_think_interval_s(type);
+    uint32 cursor = scheduler->cursors[type] % bucket->count;
+    uint32 first_deferred = bucket->count;
+    uint32 thinks = 0;
+
+    for (uint32 i = 0; i < bucket->count; i++) {
+        uint32 slot = (cursor + i) % bucket->count;
+        Entity* entity = entity_from_id(bucket->ids[slot]);
+
+        double dt_s = sim_lod_dt_s(&game_state->sim_lod, entity->position);
+        if (dt_s == 0) {
+            continue;
+        }
+
+        Brain* brain = &entity_cold(entity)->brain;
+        brain->think_elapsed_s += dt_s;
+
+        bool every_tick = brain_thinks_every_tick(brain);
+        if (!every_tick && brain->think_elapsed_s < interval_s) {
+            continue;
+        }
+
+        if (every_tick || scheduler->think_budget == 0 || *thinks_left > 0) {
+            set(brain->flags, BRAIN_F_THINKING);
+            if (*thinks_left > 0) {
+                (*thinks_left)--;
+            }
+            thinks++;
+        } else {
+            if (first_deferred == bucket->count) {
+                first_deferred = slot;
+            }
+            scheduler->deferred++;
+        }
+    }
+
+    if (first_deferred != bucket->count) {
+        scheduler->cursors[type] = first_deferred;
+    }
+    scheduler->thinks += thinks;
+
+    return thinks;
+}
+
+struct BrainBucketJob {
+    GameState* game_state;
+    BrainType type;
+    BrainBucket* bucket;
+    uint64* think_ticks; // performance counter ticks spent thinking, one per batch
+};
+
+// Brains only write their own entity and read the others' snapshots, so a bucket is split across the job threads.
+// A flagged brain thinks over the time since its last think, the others steer while their sim LOD chunk steps.
+static JOB_FUNCTION(brain_bucket_job) {
+    BrainBucketJob* job = (BrainBucketJob*)data;
+    uint64 think_ticks = 0;
+
+    for (uint32 i = start; i < end; i++) {
+        Entity* entity = entity_from_id(job->bucket->ids[i]);
+        Brain* brain = &entity_cold(entity)->brain;
+
+        if (!is_set(brain->flags, BRAIN_F_THINKING)) {
+            if (sim_lod_dt_s(&job->game_state->sim_lod, entity->position) > 0) {
+                brain_steer(entity);
+            }
+            continue;
+        }
+
+        uint64 think_start = g_get_performance_counter();
+
+        double dt_s = brain->think_elapsed_s;
+        brain->think_elapsed_s = 0;
+        brain->steer_speed = 0;
+        unset(brain->flags, BRAIN_F_THINKING);
+
+        brain_cooldown_update(entity, dt_s);
+
+        switch (job->type) {
+        case BRAIN_TYPE_BOAR:
+            brain_update_boar(entity, job->game_state, dt_s);
+            break;
+        case BRAIN_TYPE_WARRIOR:
+            brain_update_warrior(entity, job->game_state, dt_s);
+            break;
+        case BRAIN_TYPE_ROBOT_GATHERER:
+            brain_update_robot_gatherer(entity, job->game_state, dt_s);
+            break;
+        default:
+            ASSERT(false, "brain type doesn't run as a job");
+            break;
+        }
+
+        think_ticks += g_get_performance_counter() - think_start;
+    }
+
+    job->think_ticks[start / BRAIN_JOB_BATCH_SIZE] = think_ticks;
+}
+
+// Folds what this tick's thinks of a bucket took into its type's running average
+static void brain_scheduler_measure(BrainScheduler* scheduler, BrainBucketJob* job, uint32 thinks) {
+    if (thinks == 0) {
+        return;
+    }
+
+    uint64 ticks = 0;
+    uint32 batch_count = (job->bucket->count + BRAIN_JOB_BATCH_SIZE - 1) / BRAIN_JOB_BATCH_SIZE;
+    for (int i = 0; i < batch_count; i++) {
+        ticks += job->think_ticks[i];
+    }
+
+    float think_us = (float)(ticks * 1000000.0 / g_performance_frequency / thinks);
+    float* cost_us = &scheduler->think_cost_us[job->type];
+    *cost_us = *cost_us == 0 ? think_us : w_lerp(*cost_us, think_us, 0.1f);
+}
+
+// Applies what the brains of a bucket recorded, in bucket order so the outcome doesn't depend on the thread count
+static void brain_apply_intents(GameState* game_state, BrainBucket* bucket) {
+    for (int i = 0; i < bucket->count; i++) {
+        Entity* entity = entity_from_id(bucket->ids[i]);
+        Brain* brain = &entity_cold(entity)->brain;
+
+        if (is_set(brain->intents, BRAIN_INTENT_F_ATTACK_START)) {
+            entity->attack_id = get_next_attack_id(&game_state->attack_id_next);
+        }
+
+        if (is_set(brain->intents, BRAIN_INTENT_F_ATTACK_END)) {
+            remove_collision_rules(entity->attack_id, game_state);
+            entity->attack_id = 0;
+        }
+
+        if (is_set(brain->intents, BRAIN_INTENT_F_HARVEST)) {
+            Entity* target = entity_find(brain->target_handle);
+            if (target) {
+                entity_deal_damage(target, 1, game_state);
+            }
+        }
+
+        brain->intents = 0;
+    }
+}
+
+// The AI phase, each brain type's bucket is run as a batch. The player thinks first on this thread since it reads
+// input and may respawn. The scheduler then picks which of the other brains think this tick, and their buckets think
+// and steer in parallel against the snapshots taken at the tick's start.
+// Entities spawned while applying intents are appended to their bucket and first think next tick, frees are deferred
+// to the entity loop so ids stay valid while a bucket is walked.
+void brain_update_buckets(GameState* game_state, PlayerInput* player_input, double dt_s) {
+    EntityData* entity_data = &game_state->entity_data;
+    BrainBucket* buckets = entity_data->brain_buckets.buckets;
+
+    StartTimedBlock(BrainPlayer);
+    BrainBucket* players = &buckets[BRAIN_TYPE_PLAYER];
+    for (int i = 0; i < players->count; i++) {
+        Entity* entity = entity_from_id(players->ids[i]);
+        brain_cooldown_update(entity, dt_s);
+        brain_update_player(entity, game_state, player_input, dt_s);
+    }
+    EndTimedBlock(BrainPlayer);
+
+    BrainType job_types[] = {BRAIN_TYPE_BOAR, BRAIN_TYPE_WARRIOR, BRAIN_TYPE_ROBOT_GATHERER};
+    uint32 job_type_count = ArraySize(job_types);
+
+    StartTimedBlock(BrainSchedule);
+    BrainScheduler* scheduler = &game_state->brain_scheduler;
+    scheduler->thinks = 0;
+    scheduler->deferred = 0;
+    uint32 thinks_left = scheduler->think_budget;
+
+    // NOTE: the type that is scheduled first rotates every tick so one type can't keep the others out of the budget
+    uint32 think_counts[ArraySize(job_types)];
+    for (int i = 0; i < job_type_count; i++) {
+        uint32 type_idx = (scheduler->first_type + i) % job_type_count;
+        think_counts[type_idx] = brain_schedule_bucket(game_state, job_types[type_idx], &thinks_left);
+    }
+    scheduler->first_type = (scheduler->first_type + 1) % job_type_count;
+    scheduler->deferred_total += scheduler->deferred;
+    EndTimedBlock(BrainSchedule);
+
+    StartTimedBlock(BrainJobs);
+    // NOTE: perception queries walk the static grid, which otherwise rebuilds dirty chunks as they are visited
+    static_grid_rebuild_dirty(&entity_data->static_grid, entity_data);
+
+    BrainBucketJob jobs[ArraySize(job_types)];
+    JobCounter brains_done = {};
+    for (int i = 0; i < job_type_count; i++) {
+        BrainBucket* bucket = &buckets[job_types[i]];
+        uint32 batch_count = (bucket->count + BRAIN_JOB_BATCH_SIZE - 1) / BRAIN_JOB_BATCH_SIZE;
+
+        jobs[i] = {.game_state = game_state, .type = job_types[i], .bucket = bucket};
+        jobs[i].think_ticks = (uint64*)w_arena_alloc(&game_state->frame_arena, batch_count * sizeof(uint64));
+        g_jobs->parallel_for(brain_bucket_job, &jobs[i], bucket->count, BRAIN_JOB_BATCH_SIZE, &brains_done);
+    }
+    g_jobs->wait(&brains_done);
+
+    for (int i = 0; i < job_type_count; i++) {
+        brain_scheduler_measure(scheduler, &jobs[i], think_counts[i]);
+    }
+    EndTimedBlock(BrainJobs);
+
+    StartTimedBlock(BrainIntents);
+    brain_apply_intents(game_state, &buckets[BRAIN_TYPE_WARRIOR]);
+    brain_apply_intents(game_state, &buckets[BRAIN_TYPE_ROBOT_GATHERER]);
+    EndTimedBlock(BrainIntents);
 }
@@ -1,60 +1,230 @@
+// ~~~~~~~~~~~~~~~~~~~~~~~~ collision rules ~~~~~~~~~~~~~~~~~~~~~~~~ //
 
-uint32 sort_and_get_collision_hash_bucket(uint32* a_id, uint32* b_id) {
+static void collision_rule_sort_ids(uint32* a_id, uint32* b_id) {
     if (*a_id > *b_id) {
         uint32 temp = *a_id;
         *a_id = *b_id;
         *b_id = temp;
     }
+}
+
+static uint32 collision_rule_home_slot(CollisionRules* rules, uint32 a_id, uint32 b_id) {
+    return w_fmix32(a_id * 0x9e3779b1 ^ b_id) & (rules->slot_count - 1);
+}
 
-    uint32 hash_bucket = *a_id & (MAX_COLLISION_RULES - 1);
-    return hash_bucket;
+static CollisionRule** collision_rule_next(CollisionRule* rule, uint32 id) {
+    return rule->a_id == id ? &rule->a_next : &rule->b_next;
 }
 
-CollisionRule* find_collision_rule(uint32 a_id, uint32 b_id, GameState* game_state) {
-    CollisionRule** hash = game_state->collision_rule_hash;
+static CollisionRule** collision_rule_prev(CollisionRule* rule, uint32 id) {
+    return rule->a_id == id ? &rule->a_prev : &rule->b_prev;
+}
+
+// Attack ids live in their own namespace above ATTACK_ID_BIT, so entity ids can grow without colliding with them
+static CollisionRule** collision_rule_head(CollisionRules* rules, uint32 id) {
+    if (id & ATTACK_ID_BIT) {
+        ASSERT(id - ATTACK_ID_START < ATTACK_ID_MAX_IDS, "attack id out of range");
+        return &rules->attack_rules[id - ATTACK_ID_START];
+    }
+
+    return &rules->entity_rules[id];
+}
+
+static void collision_rule_link(CollisionRules* rules, CollisionRule* rule, uint32 id) {
+    CollisionRule* head = *collision_rule_head(rules, id);
+
+    *collision_rule_next(rule, id) = head;
+    *collision_rule_prev(rule, id) = NULL;
+    if (head) {
+        *collision_rule_prev(head, id) = rule;
+    }
+
+    *collision_rule_head(rules, id) = rule;
+}
+
+static void collision_rule_unlink(CollisionRules* rules, CollisionRule* rule, uint32 id) {
+    CollisionRule* prev = *collision_rule_prev(rule, id);
+    CollisionRule* next = *collision_rule_next(rule, id);
+
+    if (prev) {
+        *collision_rule_next(prev, id) = next;
+    } else {
+        *collision_rule_head(rules, id) = next;
+    }
+
+    if (next) {
+        *collision_rule_prev(next, id) = prev;
+    }
+}
+
+// Returns NULL when the main arena has no room for another block of rules
+static CollisionRule* collision_rule_alloc(GameState* game_state) {
+    CollisionRules* rules = &game_state->collision_rules;
+
+    if (!rules->free_list) {
+        Arena* arena = &game_state->main_arena;
+        if (arena->next + COLLISION_RULE_BLOCK_SIZE * sizeof(CollisionRule) + DEFAULT_ALIGNMENT >
+            arena->data + arena->size) {
+            return NULL;
+        }
+
+        CollisionRule* block = (CollisionRule*)w_arena_alloc(&game_state->main_arena,
+                                                             COLLISION_RULE_BLOCK_SIZE * sizeof(CollisionRule));
+        for (int i = 0; i < COLLISION_RULE_BLOCK_SIZE; i++) {
+            block[i].a_next = rules->free_list;
+            rules->free_list = &block[i];
+        }
+        rules->stats.capacity += COLLISION_RULE_BLOCK_SIZE;
+    }
 
-    uint32 hash_bucket = sort_and_get_collision_hash_bucket(&a_id, &b_id);
+    CollisionRule* rule = rules->free_list;
+    rules->free_list = rule->a_next;
 
-    CollisionRule* rule = 0;
-    CollisionRule* found = 0;
-    for (rule = hash[hash_bucket]; rule; rule = rule->next_rule) {
+    rules->stats.live++;
+    if (rules->stats.live > rules->stats.peak) {
+        rules->stats.peak = rules->stats.live;
+    }
+
+    return rule;
+}
+
+// Removes the rule in slot from the table, shifting back any rules in the probe chain that would otherwise be
+// unreachable
+static void collision_rule_remove_slot(CollisionRules* rules, uint32 slot) {
+    uint32 mask = rules->slot_count - 1;
+    rules->slots[slot] = NULL;
+
+    for (uint32 next = (slot + 1) & mask; rules->slots[next]; next = (next + 1) & mask) {
+        CollisionRule* rule = rules->slots[next];
+        uint32 home = collision_rule_home_slot(rules, rule->a_id, rule->b_id);
+
+        // NOTE: the rule can move into the hole only if its home slot is not cyclically within (slot, next]
+        if (((next - home) & mask) >= ((next - slot) & mask)) {
+            rules->slots[slot] = rule;
+            rules->slots[next] = NULL;
+            slot = next;
+        }
+    }
+}
+
+static uint32 collision_rule_find_slot(CollisionRules* rules, uint32 a_id, uint32 b_id) {
+    uint32 slot = collision_rule_home_slot(rules, a_id, b_id);
+
+    for (CollisionRule* rule = rules->slots[slot]; rule; rule = rules->slots[slot]) {
         if (rule->a_id == a_id && rule->b_id == b_id) {
-            found = rule;
             break;
         }
+        slot = (slot + 1) & (rules->slot_count - 1);
+    }
+
+    return slot;
+}
+
+// Reserves both slot arrays through the entity store's callbacks and commits the first COLLISION_RULE_MIN_SLOTS
+void collision_rules_init(CollisionRules* rules, EntityStore* store) {
+    rules->slots = (CollisionRule**)store->reserve_memory(COLLISION_RULE_MAX_SLOTS * sizeof(CollisionRule*));
+    rules->spare_slots = (CollisionRule**)store->reserve_memory(COLLISION_RULE_MAX_SLOTS * sizeof(CollisionRule*));
+    ASSERT(rules->slots && rules->spare_slots, "failed to reserve the collision rule slots");
+
+    bool committed = store->commit_memory(rules->slots, COLLISION_RULE_MIN_SLOTS * sizeof(CollisionRule*));
+    ASSERT(committed, "failed to commit the collision rule slots");
+    rules->slot_count = COLLISION_RULE_MIN_SLOTS;
+}
+
+// Rehashes every rule into the spare array at twice the size and swaps the arrays. Returns false and leaves the table
+// as it was when it is at COLLISION_RULE_MAX_SLOTS or the spare array can't be committed.
+static bool collision_rules_grow(CollisionRules* rules, EntityStore* store) {
+    uint32 slot_count = rules->slot_count * 2;
+    if (slot_count > COLLISION_RULE_MAX_SLOTS ||
+        !store->commit_memory(rules->spare_slots, slot_count * sizeof(CollisionRule*))) {
+        return false;
+    }
+
+    // NOTE: the spare array still holds the table from before the last grow
+    CollisionRule** old_slots = rules->slots;
+    uint32 old_slot_count = rules->slot_count;
+    memset(rules->spare_slots, 0, slot_count * sizeof(CollisionRule*));
+
+    rules->slots = rules->spare_slots;
+    rules->spare_slots = old_slots;
+    rules->slot_count = slot_count;
+
+    for (int i = 0; i < old_slot_count; i++) {
+        CollisionRule* rule = old_slots[i];
+        if (rule) {
+            rules->slots[collision_rule_find_slot(rules, rule->a_id, rule->b_id)] = rule;
+        }
     }
 
-    return found;
+    return true;
+}
+
+CollisionRule* find_collision_rule(uint32 a_id, uint32 b_id, CollisionRules* rules) {
+    collision_rule_sort_ids(&a_id, &b_id);
+
+    return rules->slots[collision_rule_find_slot(rules, a_id, b_id)];
 }
 
 void add_collision_rule(uint32 a_id, uint32 b_id, bool should_collide, GameState* game_state) {
-    CollisionRule** hash = game_state->collision_rule_hash;
-    CollisionRule** free_list = &game_state->collision_rule_free_list;
+    CollisionRules* rules = &game_state->collision_rules;
 
-    CollisionRule* found = find_collision_rule(a_id, b_id, game_state);
-    uint32 hash_bucket = sort_and_get_collision_hash_bucket(&a_id, &b_id);
+    collision_rule_sort_ids(&a_id, &b_id);
 
-    if (!found) {
-        found = *free_list;
-        if (!found) {
-            found = (CollisionRule*)w_arena_alloc(&game_state->main_arena, sizeof(CollisionRule));
-        } else {
-            *free_list = found->next_rule;
+    uint32 slot = collision_rule_find_slot(rules, a_id, b_id);
+    CollisionRule* rule = rules->slots[slot];
+
+    if (!rule) {
+        // NOTE: keep the load factor under 3/4 so probe chains stay short. A rule that doesn't fit is dropped, the
+        // pair then collides the way it would without a rule.
+        if (rules->stats.live + 1 > (rules->slot_count / 4) * 3) {
+            if (!collision_rules_grow(rules, &game_state->entity_data.store)) {
+                return;
+            }
+            slot = collision_rule_find_slot(rules, a_id, b_id);
+        }
+
+        rule = collision_rule_alloc(game_state);
+        if (!rule) {
+            return;
         }
-        found->a_id = a_id;
-        found->b_id = b_id;
-        found->next_rule = hash[hash_bucket];
-        hash[hash_bucket] = found;
+        rule->a_id = a_id;
+        rule->b_id = b_id;
+        collision_rule_link(rules, rule, a_id);
+        collision_rule_link(rules, rule, b_id);
+        rules->slots[slot] = rule;
+    }
+
+    rule->should_collide = should_collide;
+}
+
+// Removes every rule that references id, only touching the rules of that id
+void remove_collision_rules(uint32 id, GameState* game_state) {
+    CollisionRules* rules = &game_state->collision_rules;
+
+    CollisionRule** head = collision_rule_head(rules, id);
+    CollisionRule* rule = *head;
+    while (rule) {
+        CollisionRule* next = *collision_rule_next(rule, id);
+        uint32 other_id = rule->a_id == id ? rule->b_id : rule->a_id;
+
+        collision_rule_unlink(rules, rule, other_id);
+        collision_rule_remove_slot(rules, collision_rule_find_slot(rules, rule->a_id, rule->b_id));
+
+        rule->a_next = rules->free_list;
+        rules->free_list = rule;
+        rules->stats.live--;
+
+        rule = next;
     }
 
-    found->should_collide = should_collide;
+    *head = NULL;
 }
 
 // TODO: Do we need to make sure that entities marked for deletion don't collide?
-bool should_collide(Entity* entity_a, Entity* entity_b, CollisionRule** hash) {
-    float distance_between = w_euclid_dist(entity_a->position, entity_b->position);
+// NOTE: distance culling is left to the broadphase, see collision_swept_box
+bool should_collide(Entity* entity_a, Entity* entity_b, CollisionRules* rules) {
     if (entity_a->id == entity_b->id || is_set(entity_a->flags, ENTITY_F_NONSPACIAL) ||
-        is_set(entity_b->flags, ENTITY_F_NONSPACIAL) || distance_between > 10) {
+        is_set(entity_b->flags, ENTITY_F_NONSPACIAL)) {
         return false;
     }
 
@@ -63,19 +233,9 @@ bool should_collide(Entity* entity_a, Entity* entity_b, CollisionRule** hash) {
         should_collide = false;
     }
 
-    if (entity_a->id > entity_b->id) {
-        Entity* temp = entity_a;
-        entity_a = entity_b;
-        entity_b = temp;
-    }
-
-    uint32 hash_bucket = entity_a->id & (MAX_COLLISION_RULES - 1);
-    CollisionRule* rule = 0;
-    for (rule = hash[hash_bucket]; rule; rule = rule->next_rule) {
-        if (rule->a_id == entity_a->id && rule->b_id == entity_b->id) {
-            should_collide = rule->should_collide;
-            break;
-        }
+    CollisionRule* rule = find_collision_rule(entity_a->id, entity_b->id, rules);
+    if (rule) {
+        should_collide = rule->should_collide;
     }
 
     return should_collide;
@@ -84,6 +244,7 @@ bool should_collide(Entity* entity_a, Entity* entity_b, CollisionRule** hash) {
 void handle_collision(Entity* subject, Entity* target, Vec2 collision_normal, double dt_collision_s,
                       bool* can_move_freely, GameState* game_state) {
     *can_move_freely = true;
+    entity_wake(target);
 
     if (subject->type == ENTITY_TYPE_PROJECTILE) {
         if (is_set(target->flags, ENTITY_F_KILLABLE)) {
@@ -91,7 +252,7 @@ void handle_collision(Entity* subject, Entity* target, Vec2 collision_normal, do
         }
 
         if (is_set(target->flags, ENTITY_F_KILLABLE) || is_set(target->flags, ENTITY_F_BLOCKER)) {
-            set(subject->flags, ENTITY_F_MARK_FOR_DELETION);
+            entity_mark_for_deletion(subject);
         }
 
         add_collision_rule(subject->id, target->id, false, game_state);
@@ -110,3 +271,473 @@ void handle_collision(Entity* subject, Entity* target, Vec2 collision_normal, do
         *can_move_freely = false;
     }
 }
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~ broadphase ~~~~~~~~~~~~~~~~~~~~~~~~ //
+
+int collision_candidate_cmp(const void* a, const void* b) {
+    uint32 idx_a = *(const uint32*)a;
+    uint32 idx_b = *(const uint32*)b;
+
+    if (idx_a < idx_b)
+        return -1;
+    if (idx_a > idx_b)
+        return 1;
+    return 0;
+}
+
+// Returns the entity indices of dynamic bodies bucketed near [min, max] and static bodies overlapping it. Indices are
+// sorted so that ties in time of impact resolve to the same target a full scan of EntityData would pick. Only reads
+// the grids once static_grid_rebuild_dirty has run, which is what lets the broadphase jobs call it.
+static uint32 collision_query_box_ids(EntityData* entity_data, Vec2 min, Vec2 max, uint32* candidates,
+                                      uint32 max_candidates) {
+    uint32 count = spatial_grid_query(&entity_data->spatial_grid, min, max, candidates, max_candidates);
+    count += static_grid_query_overlapping(&entity_data->static_grid, entity_data, min, max, &candidates[count],
+                                           max_candidates - count);
+
+    for (int i = 0; i < count; i++) {
+        candidates[i] = entity_data->entity_lookups[candidates[i]].idx;
+    }
+
+    qsort(candidates, count, sizeof(uint32), collision_candidate_cmp);
+
+    return count;
+}
+
+static uint32 collision_query_box(GameState* game_state, Vec2 min, Vec2 max, uint32* candidates,
+                                  uint32 max_candidates) {
+    uint32 count = collision_query_box_ids(&game_state->entity_data, min, max, candidates, max_candidates);
+    game_state->collision_stats.broadphase_candidates += count;
+
+    return count;
+}
+
+// The box that holds every target subject could hit moving along subject_delta
+static void collision_swept_box(Rect subject, Vec2 subject_delta, Vec2* min, Vec2* max) {
+    // NOTE: targets are bucketed at their current position, pad by a cell to cover their own movement this tick
+    float padding = SPATIAL_GRID_CELL_DIMENSION;
+
+    *min = {subject.x - (subject.w / 2) + (float)w_min(subject_delta.x, 0) - padding,
+            subject.y - (subject.h / 2) + (float)w_min(subject_delta.y, 0) - padding};
+    *max = {subject.x + (subject.w / 2) + (float)w_max(subject_delta.x, 0) + padding,
+            subject.y + (subject.h / 2) + (float)w_max(subject_delta.y, 0) + padding};
+}
+
+struct CollisionBroadphaseJob {
+    EntityData* entity_data;
+    CollisionBroadphase* broadphase;
+    CollisionStats* stats;
+    SimLod* sim_lod;
+    uint32 max_candidates;
+};
+
+// Gathers the candidate lists of a batch of entities into the thread's arena. A query can return up to
+// max_candidates ids, so lists are written in place at the arena's end and bodies are left to the movement phase
+// once that doesn't fit anymore.
+static JOB_FUNCTION(collision_broadphase_job) {
+    CollisionBroadphaseJob* job = (CollisionBroadphaseJob*)data;
+    EntityData* entity_data = job->entity_data;
+    CollisionBroadphase* broadphase = job->broadphase;
+    Arena* arena = context->arena;
+    uint32 candidates_gathered = 0;
+
+    for (uint32 idx = start; idx < end; idx++) {
+        Entity* entity = &entity_data->entities[idx];
+        broadphase->counts[idx] = COLLISION_BROADPHASE_NONE;
+
+        bool is_resting = entity->velocity.x == 0 && entity->velocity.y == 0 && entity->acceleration.x == 0 &&
+                          entity->acceleration.y == 0;
+        if (is_resting || is_set(entity->flags, ENTITY_F_STATIC) || is_set(entity->flags, ENTITY_F_NONSPACIAL) ||
+            entity->type == ENTITY_TYPE_PROJECTILE) {
+            continue;
+        }
+
+        // NOTE: bodies whose sim LOD chunk doesn't step this tick aren't moved at all
+        double dt_s = sim_lod_dt_s(job->sim_lod, entity->position);
+        if (dt_s == 0) {
+            continue;
+        }
+
+        uint32* candidates = (uint32*)w_arena_alloc(arena, 0);
+        if ((arena->data + arena->size) - (char*)candidates < job->max_candidates * (long long)sizeof(uint32)) {
+            continue;
+        }
+
+        WorldCollider subject_collider = entity_get_world_collider(entity);
+        Vec2 subject_delta = w_calc_position_delta(entity->acceleration, entity->velocity, subject_collider.position,
+                                                   dt_s);
+        Rect subject = {subject_collider.position.x, subject_collider.position.y, subject_collider.size.x,
+                        subject_collider.size.y};
+        collision_swept_box(subject, subject_delta, &broadphase->box_min[idx], &broadphase->box_max[idx]);
+
+        uint32 count = collision_query_box_ids(entity_data, broadphase->box_min[idx], broadphase->box_max[idx],
+                                               candidates, job->max_candidates);
+        arena->next = (char*)&candidates[count];
+
+        broadphase->candidates[idx] = candidates;
+        broadphase->counts[idx] = count;
+        candidates_gathered += count;
+    }
+
+    w_atomic_add_u32(&job->stats->broadphase_candidates, candidates_gathered);
+}
+
+// Gathers the first attempt candidates of every moving body on the job threads. Must run after the brains have set
+// this tick's velocities and applied their intents and before the movement phase, each body is swept over the dt of
+// its sim LOD chunk.
+void collision_broadphase_gather(GameState* game_state, CollisionScratch* scratch) {
+    EntityData* entity_data = &game_state->entity_data;
+    CollisionBroadphase* broadphase = &scratch->broadphase;
+
+    static_grid_rebuild_dirty(&entity_data->static_grid, entity_data);
+
+    broadphase->entity_count = entity_data->entity_count;
+    broadphase->staged_count = entity_data->commands.staged_count;
+
+    CollisionBroadphaseJob job = {.entity_data = entity_data,
+                                  .broadphase = broadphase,
+                                  .stats = &game_state->collision_stats,
+                                  .sim_lod = &game_state->sim_lod,
+                                  .max_candidates = scratch->capacity};
+    JobCounter counter = {};
+    g_jobs->parallel_for(collision_broadphase_job, &job, broadphase->entity_count, COLLISION_BROADPHASE_BATCH_SIZE,
+                         &counter);
+    g_jobs->wait(&counter);
+}
+
+// Returns the gathered candidates of the entity at idx when they still cover the query box [min, max]. Bodies that
+// were pushed, turned or spawned since the gather miss and query again.
+static bool collision_broadphase_lookup(CollisionBroadphase* broadphase, EntityData* entity_data, uint32 idx,
+                                        Vec2 min, Vec2 max, uint32** candidates, uint32* count) {
+    if (idx >= broadphase->entity_count || broadphase->counts[idx] == COLLISION_BROADPHASE_NONE ||
+        entity_data->commands.staged_count != broadphase->staged_count) {
+        return false;
+    }
+
+    Vec2 gathered_min = broadphase->box_min[idx];
+    Vec2 gathered_max = broadphase->box_max[idx];
+    if (min.x < gathered_min.x || min.y < gathered_min.y || max.x > gathered_max.x || max.y > gathered_max.y) {
+        return false;
+    }
+
+    *candidates = broadphase->candidates[idx];
+    *count = broadphase->counts[idx];
+
+    return true;
+}
+
+// capacity bounds the candidates of a query and the attack hitboxes of a tick, it should cover the entity store
+CollisionScratch collision_scratch_alloc(Arena* arena, uint32 capacity) {
+    CollisionScratch scratch = {.capacity = capacity};
+    scratch.candidates = (uint32*)w_arena_alloc(arena, capacity * sizeof(uint32));
+    scratch.broadphase.candidates = (uint32**)w_arena_alloc(arena, capacity * sizeof(uint32*));
+    scratch.broadphase.counts = (uint32*)w_arena_alloc(arena, capacity * sizeof(uint32));
+    scratch.broadphase.box_min = (Vec2*)w_arena_alloc(arena, capacity * sizeof(Vec2));
+    scratch.broadphase.box_max = (Vec2*)w_arena_alloc(arena, capacity * sizeof(Vec2));
+    scratch.targets.min_x = (float*)w_arena_alloc(arena, capacity * sizeof(float));
+    scratch.targets.min_y = (float*)w_arena_alloc(arena, capacity * sizeof(float));
+    scratch.targets.max_x = (float*)w_arena_alloc(arena, capacity * sizeof(float));
+    scratch.targets.max_y = (float*)w_arena_alloc(arena, capacity * sizeof(float));
+    scratch.targets.delta_x = (float*)w_arena_alloc(arena, capacity * sizeof(float));
+    scratch.targets.delta_y = (float*)w_arena_alloc(arena, capacity * sizeof(float));
+    scratch.targets.idx = (uint32*)w_arena_alloc(arena, capacity * sizeof(uint32));
+    scratch.attack_hitboxes = (AttackHitbox*)w_arena_alloc(arena, capacity * sizeof(AttackHitbox));
+    scratch.attack_kills = (uint32*)w_arena_alloc(arena, capacity * sizeof(uint32));
+
+    return scratch;
+}
+
+// Fills targets with the candidates subject should collide with, keeping candidate order
+void collision_gather_targets(GameState* game_state, Entity* subject, uint32* candidates, uint32 candidate_count,
+                              double dt_s, CollisionTargets* targets) {
+    EntityData* entity_data = &game_state->entity_data;
+    EntityBounds* bounds = &entity_data->bounds;
+
+    targets->count = 0;
+    for (int i = 0; i < candidate_count; i++) {
+        uint32 idx = candidates[i];
+        Entity* target = &entity_data->entities[idx];
+
+        if (should_collide(subject, target, &game_state->collision_rules)) {
+            Vec2 target_delta = w_calc_position_delta(target->acceleration, target->velocity, target->position, dt_s);
+
+            uint32 target_i = targets->count++;
+            targets->min_x[target_i] = bounds->min_x[idx];
+            targets->min_y[target_i] = bounds->min_y[idx];
+            targets->max_x[target_i] = bounds->max_x[idx];
+            targets->max_y[target_i] = bounds->max_y[idx];
+            targets->delta_x[target_i] = target_delta.x;
+            targets->delta_y[target_i] = target_delta.y;
+            targets->idx[target_i] = idx;
+        }
+    }
+
+    game_state->collision_stats.pairs_tested += targets->count;
+}
+
+void collision_push_attack_hitbox(CollisionScratch* scratch, Entity* attacker, Rect hitbox) {
+    if (is_set(attacker->flags, ENTITY_F_NONSPACIAL)) {
+        return;
+    }
+
+    ASSERT(scratch->attack_hitbox_count < scratch->capacity, "too many attack hitboxes this tick");
+    scratch->attack_hitboxes[scratch->attack_hitbox_count++] = {
+        .attacker_id = attacker->id,
+        .attacker_idx = i_entity_data->entity_lookups[attacker->id].idx,
+        .attack_id = attacker->attack_id,
+        .rect = hitbox};
+}
+
+// Whether hitbox overlaps the target at idx where it stood when the attacker swung. The entity loop used to resolve
+// hitboxes inline, so targets after the attacker in the store hadn't moved yet and are tested at their tick start.
+static bool collision_attack_hitbox_overlaps(EntityData* entity_data, AttackHitbox* hitbox, uint32 idx) {
+    if (idx < hitbox->attacker_idx) {
+        return entity_bounds_overlap(idx, hitbox->rect);
+    }
+
+    Entity* target = &entity_data->entities[idx];
+    WorldCollider collider = entity_get_world_collider(target);
+    Vec2 offset = w_vec_sub(target->previous_position, target->position);
+    Rect target_rect = {collider.position.x + offset.x, collider.position.y + offset.y, collider.size.x,
+                        collider.size.y};
+
+    return w_check_aabb_overlap(hitbox->rect, target_rect);
+}
+
+// Applies damage for every hitbox gathered this tick, in the entity loop's order. Each attack hits a target at most
+// once, the collision rule added on hit stops the same attack from hitting it again on later ticks.
+void collision_resolve_attack_hitboxes(GameState* game_state, CollisionScratch* scratch) {
+    EntityData* entity_data = &game_state->entity_data;
+    uint32* candidates = scratch->candidates;
+
+    scratch->attack_kill_count = 0;
+    game_state->collision_stats.attack_hitboxes = scratch->attack_hitbox_count;
+    for (int i = 0; i < scratch->attack_hitbox_count; i++) {
+        AttackHitbox* hitbox = &scratch->attack_hitboxes[i];
+        Rect subject = hitbox->rect;
+
+        // NOTE: targets are bucketed where they ended the tick, pad by a cell to find them where they started it
+        float padding = SPATIAL_GRID_CELL_DIMENSION;
+        Vec2 min = {subject.x - (subject.w / 2) - padding, subject.y - (subject.h / 2) - padding};
+        Vec2 max = {subject.x + (subject.w / 2) + padding, subject.y + (subject.h / 2) + padding};
+        uint32 count = collision_query_box(game_state, min, max, candidates, scratch->capacity);
+
+        for (int j = 0; j < count; j++) {
+            // NOTE: entities staged this tick weren't in the entity loop
+            if (candidates[j] >= entity_data->entity_count) {
+                continue;
+            }
+
+            Entity* target = &entity_data->entities[candidates[j]];
+            if (target->id == hitbox->attacker_id || is_set(target->flags, ENTITY_F_NONSPACIAL) ||
+                !is_set(target->flags, ENTITY_F_KILLABLE)) {
+                continue;
+            }
+
+            CollisionRule* collision_rule =
+                find_collision_rule(hitbox->attack_id, target->id, &game_state->collision_rules);
+            if (collision_rule && !collision_rule->should_collide) {
+                continue;
+            }
+
+            game_state->collision_stats.pairs_tested++;
+
+            if (collision_attack_hitbox_overlaps(entity_data, hitbox, candidates[j])) {
+                uint32 hp_before = target->hp;
+                entity_deal_damage(target, 1, game_state);
+                add_collision_rule(hitbox->attack_id, target->id, false, game_state);
+
+                // NOTE: a target the loop hadn't reached yet would have died in its own iteration this tick, the
+                // others die in the next tick's loop like they used to
+                if (hp_before > 0 && target->hp <= 0 && candidates[j] > hitbox->attacker_idx) {
+                    scratch->attack_kills[scratch->attack_kill_count++] = target->id;
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < scratch->attack_kill_count; i++) {
+        entity_death(entity_from_id(scratch->attack_kills[i]));
+    }
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~ projectiles ~~~~~~~~~~~~~~~~~~~~~~~~ //
+
+static void collision_projectile_test(GameState* game_state, Entity* projectile, Rect subject, Vec2 subject_delta,
+                                      double dt_s, uint32 id, int* hit_idx, double* t_collision,
+                                      Vec2* collision_normal) {
+    EntityData* entity_data = &game_state->entity_data;
+    CollisionVisitStamps* visits = &game_state->collision_visits;
+
+    uint32 idx = entity_data->entity_lookups[id].idx;
+    if (visits->stamps[idx] == visits->stamp) {
+        return;
+    }
+    visits->stamps[idx] = visits->stamp;
+    game_state->collision_stats.broadphase_candidates++;
+
+    Entity* target = &entity_data->entities[idx];
+    if (!should_collide(projectile, target, &game_state->collision_rules)) {
+        return;
+    }
+    game_state->collision_stats.pairs_tested++;
+
+    double t = 1.0;
+    Vec2 normal = {0, 0};
+    Vec2 target_delta = w_calc_position_delta(target->acceleration, target->velocity, target->position, dt_s);
+    w_aabb_collision(subject, subject_delta, entity_data->bounds.min_x[idx], entity_data->bounds.min_y[idx],
+                     entity_data->bounds.max_x[idx], entity_data->bounds.max_y[idx], target_delta, &t, &normal);
+
+    // NOTE: ties go to the lowest entity index, same as the sorted candidates of collision_query_box_ids
+    if (t < *t_collision || (t < 1.0 && t == *t_collision && idx < (uint32)*hit_idx)) {
+        *t_collision = t;
+        *collision_normal = normal;
+        *hit_idx = idx;
+    }
+}
+
+// Returns the entity index of the earliest target the projectile hits moving along subject_delta, or -1. The pieces
+// of the path within each grid cell are queried in order, so the march stops at the first piece that starts after
+// the earliest hit found so far.
+int collision_projectile_march(GameState* game_state, Entity* projectile, Rect subject, Vec2 subject_delta, double dt_s,
+                               double* t_collision, Vec2* collision_normal) {
+    EntityData* entity_data = &game_state->entity_data;
+    CollisionVisitStamps* visits = &game_state->collision_visits;
+
+    visits->stamp++;
+    if (visits->stamp == 0) {
+        memset(visits->stamps, 0, entity_data->store.capacity * sizeof(uint32));
+        visits->stamp = 1;
+    }
+
+    // NOTE: the ray follows the projectile's center, each piece of it is widened by the projectile's half size and by a
+    // cell for the targets that moved out of the cell they are bucketed in
+    float padding_x = (subject.w / 2) + SPATIAL_GRID_CELL_DIMENSION;
+    float padding_y = (subject.h / 2) + SPATIAL_GRID_CELL_DIMENSION;
+
+    int hit_idx = -1;
+    double t_start, t_end;
+    SpatialGridRay ray = spatial_grid_ray({subject.x, subject.y}, subject_delta);
+    while (spatial_grid_ray_next(&ray, &t_start, &t_end) && t_start <= *t_collision) {
+        game_state->collision_stats.projectile_cells_marched++;
+
+        Vec2 from = {(float)(subject.x + subject_delta.x * t_start), (float)(subject.y + subject_delta.y * t_start)};
+        Vec2 to = {(float)(subject.x + subject_delta.x * t_end), (float)(subject.y + subject_delta.y * t_end)};
+        Vec2 min = {(float)w_min(from.x, to.x) - padding_x, (float)w_min(from.y, to.y) - padding_y};
+        Vec2 max = {(float)w_max(from.x, to.x) + padding_x, (float)w_max(from.y, to.y) + padding_y};
+
+        uint32 id;
+        SpatialGridIterator it = spatial_grid_iterator(&entity_data->spatial_grid, min, max);
+        while (spatial_grid_iterator_next(&entity_data->spatial_grid, &it, &id)) {
+            collision_projectile_test(game_state, projectile, subject, subject_delta, dt_s, id, &hit_idx, t_collision,
+                                      collision_normal);
+        }
+
+        StaticGridIterator static_it = static_grid_iterator(&entity_data->static_grid, min, max);
+        while (static_grid_iterator_next(&entity_data->static_grid, entity_data, &static_it, &id)) {
+            collision_projectile_test(game_state, projectile, subject, subject_delta, dt_s, id, &hit_idx, t_collision,
+                                      collision_normal);
+        }
+    }
+
+    return hit_idx;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~ movement ~~~~~~~~~~~~~~~~~~~~~~~~ //
+
+// Integrates the entity over dt_s, resolving collisions along the way. Must run after the entity's brain so it moves
+// with this tick's velocity and acceleration.
+void collision_move_entity(GameState* game_state, Entity* entity, double dt_s, CollisionScratch* scratch) {
+    CollisionTargets* targets = &scratch->targets;
+
+    if (!is_set(entity->flags, ENTITY_F_STATIC)) {
+        entity_update_sleep(entity);
+        if (is_set(entity->flags, ENTITY_F_ASLEEP)) {
+            game_state->collision_stats.bodies_asleep++;
+        } else {
+            game_state->collision_stats.bodies_awake++;
+        }
+    }
+
+    if (is_set(entity->flags, ENTITY_F_STATIC)) {
+        // NOTE: static bodies never move, they are only ever collision targets
+    } else if (is_set(entity->flags, ENTITY_F_ASLEEP)) {
+        // NOTE: sleeping entities have no velocity or acceleration so there is nothing to integrate
+    } else if (!is_set(entity->flags, ENTITY_F_NONSPACIAL)) {
+        double t_remaining = 1.0f;
+        for (int attempts = 0; attempts < 4 && t_remaining > 0.0f; attempts++) {
+            double t_min = 1.0f;
+            Vec2 collision_normal = {0, 0};
+            Entity* entity_collided_with = NULL;
+
+            WorldCollider subject_collider = entity_get_world_collider(entity);
+            Vec2 subject_delta = w_calc_position_delta(entity->acceleration, entity->velocity,
+                                                       subject_collider.position, t_remaining * dt_s);
+            Rect subject = {subject_collider.position.x, subject_collider.position.y, subject_collider.size.x,
+                            subject_collider.size.y};
+
+            int hit_idx = -1;
+            if (entity->type == ENTITY_TYPE_PROJECTILE) {
+                hit_idx = collision_projectile_march(game_state, entity, subject, subject_delta, dt_s, &t_min,
+                                                     &collision_normal);
+            } else {
+                Vec2 box_min, box_max;
+                collision_swept_box(subject, subject_delta, &box_min, &box_max);
+
+                uint32* candidates = scratch->candidates;
+                uint32 candidate_count;
+                if (attempts > 0 || !collision_broadphase_lookup(&scratch->broadphase, &game_state->entity_data,
+                                                                 entity - game_state->entity_data.entities, box_min,
+                                                                 box_max, &candidates, &candidate_count)) {
+                    candidate_count =
+                        collision_query_box(game_state, box_min, box_max, scratch->candidates, scratch->capacity);
+                }
+
+                collision_gather_targets(game_state, entity, candidates, candidate_count, dt_s, targets);
+
+                int target_hit = w_aabb_collision_batch(subject, subject_delta, targets->min_x, targets->min_y,
+                                                        targets->max_x, targets->max_y, targets->delta_x,
+                                                        targets->delta_y, targets->count, &t_min, &collision_normal);
+
+                if (target_hit >= 0) {
+                    hit_idx = targets->idx[target_hit];
+                }
+            }
+
+            if (hit_idx >= 0) {
+                entity_collided_with = &game_state->entity_data.entities[hit_idx];
+            }
+
+            if (t_min < 1) {
+                t_min = w_max(0.0, t_min - 0.8); // epsilon adjustment
+            }
+
+            double t_effective = t_min * t_remaining;
+            t_remaining -= t_effective;
+            double effective_dt_s = t_effective * dt_s;
+
+            bool can_move_freely = true;
+            if (entity_collided_with) {
+                handle_collision(entity, entity_collided_with, collision_normal, effective_dt_s, &can_move_freely,
+                                 game_state);
+            }
+
+            if (can_move_freely) {
+                entity->position =
+                    w_calc_position(entity->acceleration, entity->velocity, entity->position, effective_dt_s);
+                entity->velocity = w_calc_velocity(entity->acceleration, entity->velocity, effective_dt_s);
+            }
+
+            // NOTE: a projectile stops at the first killable or blocker it hits
+            if (is_set(entity->flags, ENTITY_F_MARK_FOR_DELETION) && entity->type == ENTITY_TYPE_PROJECTILE) {
+                break;
+            }
+        }
+    } else {
+        entity->position = w_calc_position(entity->acceleration, entity->velocity, entity->position, dt_s);
+        entity->velocity = w_calc_velocity(entity->acceleration, entity->velocity, dt_s);
+    }
+
+    if (!is_set(entity->flags, ENTITY_F_ASLEEP)) {
+        entity_spatial_update(entity);
+    }
+}
@@ -12,36 +12,23 @@ struct CraftingRecipe {
     CraftingIngredient ingredients[CRAFTING_MAX_INGREDIENTS];
 };
 
-static CraftingRecipe crafting_recipe_books[CRAFTING_RECIPE_BOOK_COUNT][ENTITY_TYPE_COUNT];
-
-void crafting_init() {
-    CraftingRecipe* general_recipes = crafting_recipe_books[CRAFTING_RECIPE_BOOK_GENERAL];
-    uint32 general_recipes_count = 0;
-    general_recipes[general_recipes_count++] = {.entity_type = ENTITY_TYPE_CHEST_IRON,
-                                                .ingredients = {{.entity_type = ENTITY_TYPE_IRON, .quantity = 4}}};
-
-    ASSERT(general_recipes_count < ENTITY_TYPE_COUNT, "too many general recipes");
-
-    CraftingRecipe* structure_recipes = crafting_recipe_books[CRAFTING_RECIPE_BOOK_STRUCTURES];
-    uint32 structure_recipes_count = 0;
-    structure_recipes[structure_recipes_count++] = {.entity_type = ENTITY_TYPE_ROBOTICS_FACTORY,
-                                                    .ingredients = {{.entity_type = ENTITY_TYPE_IRON, .quantity = 20},
-                                                                    {.entity_type = ENTITY_TYPE_COAL, .quantity = 40}}};
-
-    ASSERT(structure_recipes_count < ENTITY_TYPE_COUNT, "too many structure recipes");
-
-    CraftingRecipe* robot_recipes = crafting_recipe_books[CRAFTING_RECIPE_BOOK_ROBOTS];
-    uint32 robot_recipes_count = 0;
-    robot_recipes[robot_recipes_count++] = {.entity_type = ENTITY_TYPE_ROBOT_GATHERER,
-                                            .ingredients = {{.entity_type = ENTITY_TYPE_IRON, .quantity = 1},
-                                                            {.entity_type = ENTITY_TYPE_COAL, .quantity = 2}}};
-
-    ASSERT(robot_recipes_count < ENTITY_TYPE_COUNT, "too many robot recipes");
+// NOTE: recipes are packed at the front of each book, the first ENTITY_TYPE_UNKNOWN entry ends the book
+static const CraftingRecipe crafting_recipe_books[CRAFTING_RECIPE_BOOK_COUNT][ENTITY_TYPE_COUNT] = {
+    [CRAFTING_RECIPE_BOOK_GENERAL] = {{.entity_type = ENTITY_TYPE_CHEST_IRON,
+                                       .ingredients = {{.entity_type = ENTITY_TYPE_IRON, .quantity = 4}}}},
+
+    [CRAFTING_RECIPE_BOOK_STRUCTURES] = {{.entity_type = ENTITY_TYPE_ROBOTICS_FACTORY,
+                                          .ingredients = {{.entity_type = ENTITY_TYPE_IRON, .quantity = 20},
+                                                          {.entity_type = ENTITY_TYPE_COAL, .quantity = 40}}}},
+
+    [CRAFTING_RECIPE_BOOK_ROBOTS] = {{.entity_type = ENTITY_TYPE_ROBOT_GATHERER,
+                                      .ingredients = {{.entity_type = ENTITY_TYPE_IRON, .quantity = 1},
+                                                      {.entity_type = ENTITY_TYPE_COAL, .quantity = 2}}}},
 };
 
-CraftingRecipe* crafting_recipe_find(CraftingRecipeBook recipe_book_type, EntityType entity_type) {
-    CraftingRecipe* recipe_book = crafting_recipe_books[recipe_book_type];
-    CraftingRecipe* recipe = NULL;
+const CraftingRecipe* crafting_recipe_find(CraftingRecipeBook recipe_book_type, EntityType entity_type) {
+    const CraftingRecipe* recipe_book = crafting_recipe_books[recipe_book_type];
+    const CraftingRecipe* recipe = NULL;
 
     for (int i = 0; i < ENTITY_TYPE_COUNT; i++) {
         if (recipe_book[i].entity_type == entity_type) {
@@ -52,10 +39,10 @@ CraftingRecipe* crafting_recipe_find(CraftingRecipeBook recipe_book_type, Entity
     return recipe;
 }
 
-CraftingRecipe* crafting_recipe_find(CraftingRecipeBook recipe_book_type, uint32 idx) {
+const CraftingRecipe* crafting_recipe_find(CraftingRecipeBook recipe_book_type, uint32 idx) {
     ASSERT(idx < ENTITY_TYPE_COUNT, "crafting recipe_find index out of range");
 
-    CraftingRecipe* recipe = &crafting_recipe_books[recipe_book_type][idx];
+    const CraftingRecipe* recipe = &crafting_recipe_books[recipe_book_type][idx];
     if (recipe->entity_type == ENTITY_TYPE_UNKNOWN) {
         recipe = NULL;
     }
@@ -64,14 +51,14 @@ CraftingRecipe* crafting_recipe_find(CraftingRecipeBook recipe_book_type, uint32
 }
 
 bool crafting_can_craft_item(CraftingRecipeBook recipe_book_type, EntityType entity_type, Inventory* inventory) {
-    CraftingRecipe* recipe = crafting_recipe_find(recipe_book_type, entity_type);
+    const CraftingRecipe* recipe = crafting_recipe_find(recipe_book_type, entity_type);
 
     if (!recipe) {
         return false;
     }
 
     for (int i = 0; i < CRAFTING_MAX_INGREDIENTS; i++) {
-        CraftingIngredient* ingredient = &recipe->ingredients[i];
+        const CraftingIngredient* ingredient = &recipe->ingredients[i];
         if (ingredient->entity_type != ENTITY_TYPE_UNKNOWN &&
             !inventory_contains_item(inventory, ingredient->entity_type, ingredient->quantity)) {
             return false;
@@ -82,7 +69,7 @@ bool crafting_can_craft_item(CraftingRecipeBook recipe_book_type, EntityType ent
 }
 
 void crafting_consume_ingredients(Inventory* inventory, CraftingRecipeBook recipe_book_type, EntityType entity_type) {
-    CraftingRecipe* recipe = crafting_recipe_find(recipe_book_type, entity_type);
+    const CraftingRecipe* recipe = crafting_recipe_find(recipe_book_type, entity_type);
     ASSERT(recipe, "crafting_consume_ingredients - recipe not found!");
     if (crafting_can_craft_item(recipe_book_type, entity_type, inventory)) {
         for (int i = 0; i < CRAFTING_MAX_INGREDIENTS && recipe->ingredients[i].entity_type != ENTITY_TYPE_UNKNOWN;
@@ -95,21 +82,28 @@ void crafting_consume_ingredients(Inventory* inventory, CraftingRecipeBook recip
 
 void crafting_craft_item(EntityType entity_type, CraftingRecipeBook recipe_book_type, Inventory* source_inventory,
                          Inventory* destination_inventory) {
-    CraftingRecipe* recipe = crafting_recipe_find(recipe_book_type, entity_type);
+    const CraftingRecipe* recipe = crafting_recipe_find(recipe_book_type, entity_type);
 
     ASSERT(recipe, "Attempting to craft an item without a recipe");
 
     if (inventory_space_for_item(entity_type, 1, destination_inventory) &&
         crafting_can_craft_item(recipe_book_type, entity_type, source_inventory)) {
+        // NOTE: the crafted entity is made first so nothing is used up when the entity store is full
+        Entity* new_entity = NULL;
+        if (inventory_should_persist_entity(entity_type)) {
+            new_entity = entity_find(entity_create(entity_type, {}));
+            if (!new_entity) {
+                return;
+            }
+        }
+
         for (int i = 0; i < CRAFTING_MAX_INGREDIENTS && recipe->ingredients[i].entity_type != ENTITY_TYPE_UNKNOWN;
              i++) {
             CraftingIngredient ingredient = recipe->ingredients[i];
             inventory_remove_items(source_inventory, ingredient.entity_type, ingredient.quantity);
         }
 
-        if (inventory_should_persist_entity(entity_type)) {
-            EntityHandle handle = entity_create(entity_type, {});
-            Entity* new_entity = entity_find(handle);
+        if (new_entity) {
             inventory_add_entity_item(destination_inventory, new_entity);
         } else {
             inventory_add_item(destination_inventory, entity_type, 1);
@@ -121,9 +115,9 @@ void crafting_craft_item(EntityType entity_type, CraftingRecipeBook recipe_book_
     crafting_craft_item(entity_type, recipe_book_type, inventory, inventory);
 }
 
-Inventory recipes_to_inventory(CraftingRecipeBook recipe_book_type, uint32 capacity) {
-    CraftingRecipe* recipes = crafting_recipe_books[recipe_book_type];
-    Inventory inventory = {};
+Inventory recipes_to_inventory(CraftingRecipeBook recipe_book_type, uint32 capacity, Arena* arena) {
+    const CraftingRecipe* recipes = crafting_recipe_books[recipe_book_type];
+    Inventory inventory = inventory_alloc(arena, ENTITY_TYPE_COUNT);
 
     for (int i = 0; i < ENTITY_TYPE_COUNT; i++) {
         CraftingRecipe recipe = recipes[i];
@@ -143,22 +137,25 @@ Inventory recipes_to_inventory(CraftingRecipeBook recipe_book_type, uint32 capac
 
 void crafting_recipe_info_render(UIElement* container, Vec2 container_size, CraftingRecipeBook recipe_book_type,
                                  uint32 recipe_idx) {
-    CraftingRecipe* recipe = crafting_recipe_find(recipe_book_type, recipe_idx);
+    const CraftingRecipe* recipe = crafting_recipe_find(recipe_book_type, recipe_idx);
     if (!recipe) {
         return;
     }
 
-    EntityInfo* e_info = &entity_info[recipe->entity_type];
+    const EntityInfo* e_info = &entity_info[recipe->entity_type];
 
     UIElement* title = ui_create_text(
         e_info->type_name_string,
         {.rgba = COLOR_WHITE, .font_scale = 1, .max_width = container_size.x - (container->padding * 2)});
-    UIElement* description = ui_create_text(
-        e_info->description,
-        {.rgba = COLOR_WHITE, .font_scale = 1, .max_width = container_size.x - (container->padding * 2)});
 
     ui_push(container, title);
-    ui_push(container, description);
+
+    if (e_info->description) {
+        UIElement* description = ui_create_text(
+            e_info->description,
+            {.rgba = COLOR_WHITE, .font_scale = 1, .max_width = container_size.x - (container->padding * 2)});
+        ui_push(container, description);
+    }
 
     for (int i = 0; i < CRAFTING_MAX_INGREDIENTS && recipe->ingredients[i].entity_type != ENTITY_TYPE_UNKNOWN; i++) {
         CraftingIngredient ingredient = recipe->ingredients[i];
@@ -1,10 +1,58 @@
 #include "imgui.h"
 #include "game.h"
 
+const char* tools_profile_timer_names[ProfileTimerIDCount] = {
+    "Game state initialization", "Brain player", "Brain schedule", "Brain jobs", "Brain intents", "Sim tick",
+};
+
 void tools_init(Tools* tools) {
     tools->camera_zoom = 1.0f;
 }
 
+// Lists what changed since the last entity_dirty_clear, which the frame runs right after the panel. Ids that were
+// freed since are listed without a type.
+static void tools_dirty_list(EntityData* entity_data) {
+    EntityDirtySet* dirty = &entity_data->dirty;
+    if (!ImGui::TreeNode("Dirty", "Changed last frame: %u", dirty->count)) {
+        return;
+    }
+
+    const char* bit_names[] = {"transform", "visual", "inventory", "lifecycle"};
+    uint32 bit_counts[ArraySize(bit_names)] = {};
+    for (int i = 0; i < dirty->count; i++) {
+        for (int bit = 0; bit < ArraySize(bit_names); bit++) {
+            if (is_set(dirty->bits[dirty->ids[i]], 1 << bit)) {
+                bit_counts[bit]++;
+            }
+        }
+    }
+    ImGui::Text("Transform: %u visual: %u inventory: %u lifecycle: %u", bit_counts[0], bit_counts[1], bit_counts[2],
+                bit_counts[3]);
+
+    ImGuiListClipper clipper;
+    clipper.Begin(dirty->count);
+    while (clipper.Step()) {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+            uint32 id = dirty->ids[i];
+            uint32 idx = entity_data->entity_lookups[id].idx;
+            bool alive = idx < entity_data->entity_count && entity_data->entities[idx].id == id;
+            const char* type_name = alive ? entity_info[entity_data->entities[idx].type].type_name_string : "freed";
+
+            char bits_string[64] = {};
+            for (int bit = 0; bit < ArraySize(bit_names); bit++) {
+                if (is_set(dirty->bits[id], 1 << bit)) {
+                    strcat(bits_string, bit_names[bit]);
+                    strcat(bits_string, " ");
+                }
+            }
+
+            ImGui::Text("%u %s: %s", id, type_name ? type_name : "", bits_string);
+        }
+    }
+
+    ImGui::TreePop();
+}
+
 void sprite_to_uv_coordinates(SpriteID sprite_id, Vec2 texture_size, Vec2* uv0, Vec2* uv1) {
     Sprite sprite = sprite_table[sprite_id];
 
@@ -56,6 +104,9 @@ void tools_render_panel(GameMemory* game_memory, GameState* game_state, GameInpu
         Vec2 mouse_world_position = game_state->world_input.mouse_position_world;
 
         ImGui::Text("Mouse coord: %.3f, %.3f", mouse_world_position.x, mouse_world_position.y);
+        ImGui::Text("Sim ticks this frame: %u (%u Hz)", game_state->sim_ticks_this_frame,
+                    game_memory->sim_tick_rate_hz);
+        ImGui::Text("Job threads: %u", game_memory->jobs.thread_count);
 
         ImGui::Checkbox("Draw colliders", &game_state->tools.draw_colliders);
         ImGui::Checkbox("Draw entity positions", &game_state->tools.draw_entity_positions);
@@ -64,7 +115,22 @@ void tools_render_panel(GameMemory* game_memory, GameState* game_state, GameInpu
 
         if (ImGui::CollapsingHeader("Entity")) {
             ImGui::Text("Entity count: %i", game_state->entity_data.entity_count);
-            ImGui::Text("Max entity count: %i", MAX_ENTITIES);
+            ImGui::Text("Entity capacity: %u / %i", game_state->entity_data.store.capacity, MAX_ENTITIES);
+            tools_dirty_list(&game_state->entity_data);
+            ImGui::Text("Spatial reorders: %u", game_state->entity_data.reorder.reorder_count);
+            ImGui::Checkbox("Disable spatial reorder", &game_state->tools.disable_entity_reorder);
+
+            if (ImGui::TreeNode("Counts by type")) {
+                for (int i = 0; i < ENTITY_TYPE_COUNT; i++) {
+                    uint32 count = entity_type_count((EntityType)i);
+                    if (count > 0) {
+                        ImGui::Text("%s: %u", entity_info[i].type_name_string, count);
+                    }
+                }
+
+                ImGui::TreePop();
+            }
+
             ImGui::Checkbox("World init", &game_state->tools.entity_palette_should_add_to_init);
 
             ImGui::SameLine();
@@ -182,6 +248,53 @@ void tools_render_panel(GameMemory* game_memory, GameState* game_state, GameInpu
             }
         }
 
+        if (ImGui::CollapsingHeader("Brains")) {
+            BrainScheduler* scheduler = &game_state->brain_scheduler;
+            ImGui::DragInt("Think budget (thinks per tick)", (int*)&scheduler->think_budget, 8, 0, 100000);
+            ImGui::Text("Thinks: %u deferred: %u", scheduler->thinks, scheduler->deferred);
+            ImGui::Text("Deferred since start: %llu", (unsigned long long)scheduler->deferred_total);
+            ImGui::Text("Think cost boar: %.2f us warrior: %.2f us robot: %.2f us",
+                        scheduler->think_cost_us[BRAIN_TYPE_BOAR], scheduler->think_cost_us[BRAIN_TYPE_WARRIOR],
+                        scheduler->think_cost_us[BRAIN_TYPE_ROBOT_GATHERER]);
+        }
+
+        if (ImGui::CollapsingHeader("Sim LOD")) {
+            SimLod* sim_lod = &game_state->sim_lod;
+            ImGui::Text("Chunks near: %u mid: %u far: %u", sim_lod->tier_counts[SIM_LOD_TIER_NEAR],
+                        sim_lod->tier_counts[SIM_LOD_TIER_MID], sim_lod->tier_counts[SIM_LOD_TIER_FAR]);
+            ImGui::Text("Mid chunks step every %u ticks, far chunks run timers every %u ticks",
+                        SIM_LOD_MID_TICK_INTERVAL, SIM_LOD_FAR_TICK_INTERVAL);
+            ImGui::Checkbox("Draw chunk tiers", &game_state->tools.draw_sim_lod);
+            ImGui::Checkbox("Disable sim LOD", &game_state->tools.disable_sim_lod);
+        }
+
+        if (ImGui::CollapsingHeader("Collision")) {
+            CollisionStats* collision_stats = &game_state->collision_stats;
+            ImGui::Text("Broadphase candidates: %u", collision_stats->broadphase_candidates);
+            ImGui::Text("Pairs tested: %u", collision_stats->pairs_tested);
+            ImGui::Text("Attack hitboxes: %u", collision_stats->attack_hitboxes);
+            ImGui::Text("Bodies awake: %u asleep: %u", collision_stats->bodies_awake, collision_stats->bodies_asleep);
+            ImGui::Text("Projectile cells marched: %u", collision_stats->projectile_cells_marched);
+
+            StaticGrid* static_grid = &game_state->entity_data.static_grid;
+            ImGui::Text("Static bodies: %u", static_grid->count);
+            ImGui::Text("Static chunk rebuilds: %u", static_grid->rebuilds);
+
+            CollisionRuleStats* rule_stats = &game_state->collision_rules.stats;
+            ImGui::Text("Collision rules live: %u", rule_stats->live);
+            ImGui::Text("Collision rules peak: %u", rule_stats->peak);
+            ImGui::Text("Collision rules capacity: %u", rule_stats->capacity);
+            ImGui::Text("Collision rule slots: %u", game_state->collision_rules.slot_count);
+        }
+
+        if (ImGui::CollapsingHeader("Profiler")) {
+            ProfileTimer* profile_timers = game_memory->debug_info.profile_timers;
+            for (int i = 0; i < ProfileTimerIDCount; i++) {
+                ImGui::Text("%s: %.3f ms (%u hits)", tools_profile_timer_names[i], profile_timers[i].time_elapsed_ms,
+                            profile_timers[i].hit_count);
+            }
+        }
+
         if (ImGui::CollapsingHeader("Render groups")) {
         }
 
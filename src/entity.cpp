@@ -16,6 +16,15 @@ struct EntityAnimations {
 #define ENTITY_INFO_F_PERSIST_IN_INVENTORY (1 << 0)
 #define ENTITY_INFO_F_PLACEABLE (1 << 1)
 #define ENTITY_INFO_F_FOOD (1 << 2)
+#define ENTITY_INFO_F_STATIC (1 << 3) // never moves, kept in the static grid instead of the dynamic one
+
+// How a type's collider differs from the size of its default sprite
+struct ColliderAdjustments {
+    float offset_x;
+    float offset_y;
+    float size_x;
+    float size_y;
+};
 
 struct EntityItemSpawnInfo {
     EntityType spawned_entity_type;
@@ -23,33 +32,311 @@ struct EntityItemSpawnInfo {
     float spawn_chance;
 };
 
+// Per type data, it doubles as the prototype entity_spawn builds new instances from
 struct EntityInfo {
     flags flags;
     uint32 instance_flags;
     EntityAnimations animations;
     SpriteID default_sprite;
-    char type_name_string[256];
+    const char* type_name_string;
     uint32 hunger_gain;
-    Collider collider;
-    char description[512];
+    ColliderAdjustments collider_adjustments;
+    const char* description;
     uint32 base_hp;
     EntityItemSpawnInfo spawn_info;
     uint32 inventory_capacity;
     BrainType brain_type;
+    AnimationID spawn_animation;
+    uint32 base_hunger;
+    uint32 party_capacity;
 };
 
-EntityInfo entity_info[ENTITY_TYPE_COUNT] = {};
-
 EntityHandle entity_null_handle = {.generation = -1};
 
 static EntityData* i_entity_data = NULL;
 
-struct ColliderAdjustments {
-    float offset_x;
-    float offset_y;
-    float size_x;
-    float size_y;
-};
+static Entity* entity_from_id(uint32 id) {
+    return &i_entity_data->entities[i_entity_data->entity_lookups[id].idx];
+}
+
+// Returns the cold components of an entity, they are kept at the entity's index so swap-removes move them together
+EntityCold* entity_cold(Entity* entity) {
+    ASSERT(entity >= i_entity_data->entities && entity < &i_entity_data->entities[i_entity_data->store.capacity],
+           "entity is not in EntityData");
+
+    return &i_entity_data->cold[entity - i_entity_data->entities];
+}
+
+// Entities without storage get the pool's empty inventory, so capacity is 0 and there are no items
+Inventory* entity_inventory(Entity* entity) {
+    return &i_entity_data->inventory_pool.inventories[entity_cold(entity)->inventory_id];
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~ brain buckets ~~~~~~~~~~~~~~~~~~~~~~~~ //
+
+static void entity_brain_bucket_add(BrainType type, uint32 id) {
+    BrainBuckets* buckets = &i_entity_data->brain_buckets;
+    BrainBucket* bucket = &buckets->buckets[type];
+
+    buckets->slots[id] = bucket->count;
+    bucket->ids[bucket->count++] = id;
+}
+
+static void entity_brain_bucket_remove(BrainType type, uint32 id) {
+    BrainBuckets* buckets = &i_entity_data->brain_buckets;
+    BrainBucket* bucket = &buckets->buckets[type];
+    uint32 slot = buckets->slots[id];
+
+    ASSERT(slot < bucket->count && bucket->ids[slot] == id, "entity is not in its brain bucket");
+
+    uint32 last_id = bucket->ids[--bucket->count];
+    bucket->ids[slot] = last_id;
+    buckets->slots[last_id] = slot;
+}
+
+// Brain types must only be changed through here so the AI phase's buckets stay in sync
+void entity_set_brain_type(Entity* entity, BrainType type) {
+    Brain* brain = &entity_cold(entity)->brain;
+
+    if (brain->type != BRAIN_TYPE_NONE) {
+        entity_brain_bucket_remove(brain->type, entity->id);
+    }
+
+    brain->type = type;
+
+    if (type != BRAIN_TYPE_NONE) {
+        entity_brain_bucket_add(type, entity->id);
+    }
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~ type lists ~~~~~~~~~~~~~~~~~~~~~~~~ //
+
+static void entity_type_list_add(EntityType type, uint32 id) {
+    EntityTypeLists* lists = &i_entity_data->type_lists;
+    uint32 head = lists->heads[type];
+
+    lists->next[id] = head;
+    lists->prev[id] = ENTITY_TYPE_LIST_NULL;
+    if (head != ENTITY_TYPE_LIST_NULL) {
+        lists->prev[head] = id;
+    }
+
+    lists->heads[type] = id;
+    lists->counts[type]++;
+}
+
+static void entity_type_list_remove(EntityType type, uint32 id) {
+    EntityTypeLists* lists = &i_entity_data->type_lists;
+    uint32 prev = lists->prev[id];
+    uint32 next = lists->next[id];
+
+    ASSERT(lists->counts[type] > 0, "entity is not in its type list");
+
+    if (prev != ENTITY_TYPE_LIST_NULL) {
+        lists->next[prev] = next;
+    } else {
+        lists->heads[type] = next;
+    }
+
+    if (next != ENTITY_TYPE_LIST_NULL) {
+        lists->prev[next] = prev;
+    }
+
+    lists->counts[type]--;
+}
+
+void entity_type_lists_clear(EntityTypeLists* lists) {
+    for (int i = 0; i < ENTITY_TYPE_COUNT; i++) {
+        lists->heads[i] = ENTITY_TYPE_LIST_NULL;
+        lists->counts[i] = 0;
+    }
+}
+
+uint32 entity_type_count(EntityType type) {
+    return i_entity_data->type_lists.counts[type];
+}
+
+// Entities of a type are walked with entity_find_first_of_type and entity_next_of_type, in no particular order
+Entity* entity_find_first_of_type(EntityType type) {
+    uint32 head = i_entity_data->type_lists.heads[type];
+
+    return head != ENTITY_TYPE_LIST_NULL ? entity_from_id(head) : NULL;
+}
+
+Entity* entity_next_of_type(Entity* entity) {
+    uint32 next = i_entity_data->type_lists.next[entity->id];
+
+    return next != ENTITY_TYPE_LIST_NULL ? entity_from_id(next) : NULL;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~ dirty tracking ~~~~~~~~~~~~~~~~~~~~~~~~ //
+
+// NOTE: atomic since brain jobs mark the entities they think for, only the first mark of an id appends it
+void entity_mark_dirty_id(uint32 id, flags dirty_flags) {
+    EntityDirtySet* dirty = &i_entity_data->dirty;
+
+    if (w_atomic_or_u8(&dirty->bits[id], (uint8)dirty_flags) == 0) {
+        dirty->ids[w_atomic_add_u32(&dirty->count, 1)] = id;
+    }
+}
+
+// Mutating helpers call this with what they changed, see ENTITY_DIRTY_TRANSFORM and friends
+void entity_mark_dirty(Entity* entity, flags dirty_flags) {
+    entity_mark_dirty_id(entity->id, dirty_flags);
+}
+
+flags entity_dirty_bits(Entity* entity) {
+    return i_entity_data->dirty.bits[entity->id];
+}
+
+// Forgets the changes of the last frame, called once every consumer has seen them. The tools panel lists them in
+// DEBUG builds.
+void entity_dirty_clear() {
+    EntityDirtySet* dirty = &i_entity_data->dirty;
+
+    for (int i = 0; i < dirty->count; i++) {
+        dirty->bits[dirty->ids[i]] = 0;
+    }
+
+    dirty->count = 0;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~ snapshots ~~~~~~~~~~~~~~~~~~~~~~~~ //
+
+// Called at the start of every sim tick before the brains, nothing may be staged
+void entity_snapshot_take() {
+    for (int i = 0; i < i_entity_data->entity_count; i++) {
+        Entity* entity = &i_entity_data->entities[i];
+        i_entity_data->snapshots[entity->id] = {.position = entity->position, .hp = entity->hp, .flags = entity->flags};
+    }
+}
+
+EntitySnapshot* entity_snapshot(uint32 id) {
+    return &i_entity_data->snapshots[id];
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~ spatial reorder ~~~~~~~~~~~~~~~~~~~~~~~~ //
+
+static uint32 entity_morton_spread(uint32 value) {
+    value &= 0xFFFF;
+    value = (value | (value << 8)) & 0x00FF00FF;
+    value = (value | (value << 4)) & 0x0F0F0F0F;
+    value = (value | (value << 2)) & 0x33333333;
+    value = (value | (value << 1)) & 0x55555555;
+
+    return value;
+}
+
+// Interleaves the bits of the spatial grid cell coordinates of position, unclamped so far away entities still sort
+static uint32 entity_morton_key(Vec2 position) {
+    uint32 x = (uint32)((int)w_floorf(position.x / SPATIAL_GRID_CELL_DIMENSION) + 0x8000);
+    uint32 y = (uint32)((int)w_floorf(position.y / SPATIAL_GRID_CELL_DIMENSION) + 0x8000);
+
+    return entity_morton_spread(x) | (entity_morton_spread(y) << 1);
+}
+
+static int entity_reorder_key_cmp(const void* a, const void* b) {
+    uint64 key_a = *(const uint64*)a;
+    uint64 key_b = *(const uint64*)b;
+
+    return (key_a > key_b) - (key_a < key_b);
+}
+
+static void entity_reorder_copy_slot(uint32 to_idx, uint32 from_idx) {
+    EntityBounds* bounds = &i_entity_data->bounds;
+
+    i_entity_data->entities[to_idx] = i_entity_data->entities[from_idx];
+    i_entity_data->cold[to_idx] = i_entity_data->cold[from_idx];
+    i_entity_data->entity_ids[to_idx] = i_entity_data->entity_ids[from_idx];
+    bounds->min_x[to_idx] = bounds->min_x[from_idx];
+    bounds->min_y[to_idx] = bounds->min_y[from_idx];
+    bounds->max_x[to_idx] = bounds->max_x[from_idx];
+    bounds->max_y[to_idx] = bounds->max_y[from_idx];
+}
+
+// Sorts the live entities by the keys in reorder.keys, whose low halves are the index each slot takes its entity from.
+// Every cycle of the permutation is walked once with a single slot held aside, then the lookups are pointed at the new
+// indices. Ids don't change, so handles, the grids and everything else indexed by id stay valid.
+void entity_reorder_by_keys() {
+    EntityReorder* reorder = &i_entity_data->reorder;
+    uint64* keys = reorder->keys;
+    uint32 count = i_entity_data->entity_count;
+
+    ASSERT(!i_entity_data->commands.recording && i_entity_data->commands.staged_count == 0,
+           "the entity store can't be reordered while entity commands are recorded");
+
+    qsort(keys, count, sizeof(uint64), entity_reorder_key_cmp);
+
+    EntityBounds* bounds = &i_entity_data->bounds;
+    for (uint32 start = 0; start < count; start++) {
+        uint32 from_idx = (uint32)keys[start] & ENTITY_REORDER_IDX_MASK;
+        if (from_idx == start || is_set((uint32)keys[start], ENTITY_REORDER_DONE_BIT)) {
+            continue;
+        }
+
+        Entity held_entity = i_entity_data->entities[start];
+        EntityCold held_cold = i_entity_data->cold[start];
+        uint32 held_id = i_entity_data->entity_ids[start];
+        float held_bounds[4] = {bounds->min_x[start], bounds->min_y[start], bounds->max_x[start],
+                                bounds->max_y[start]};
+
+        uint32 to_idx = start;
+        while (from_idx != start) {
+            entity_reorder_copy_slot(to_idx, from_idx);
+            keys[to_idx] |= ENTITY_REORDER_DONE_BIT;
+
+            to_idx = from_idx;
+            from_idx = (uint32)keys[to_idx] & ENTITY_REORDER_IDX_MASK;
+        }
+
+        i_entity_data->entities[to_idx] = held_entity;
+        i_entity_data->cold[to_idx] = held_cold;
+        i_entity_data->entity_ids[to_idx] = held_id;
+        bounds->min_x[to_idx] = held_bounds[0];
+        bounds->min_y[to_idx] = held_bounds[1];
+        bounds->max_x[to_idx] = held_bounds[2];
+        bounds->max_y[to_idx] = held_bounds[3];
+        keys[to_idx] |= ENTITY_REORDER_DONE_BIT;
+    }
+
+    for (uint32 idx = 0; idx < count; idx++) {
+        i_entity_data->entity_lookups[i_entity_data->entity_ids[idx]].idx = idx;
+    }
+
+    reorder->ticks_since = 0;
+    reorder->frees_since = 0;
+    reorder->reorder_count++;
+}
+
+void entity_reorder_spatially() {
+    uint64* keys = i_entity_data->reorder.keys;
+
+    for (uint32 idx = 0; idx < i_entity_data->entity_count; idx++) {
+        keys[idx] = ((uint64)entity_morton_key(i_entity_data->entities[idx].position) << 32) | idx;
+    }
+
+    entity_reorder_by_keys();
+}
+
+// Called once per tick at the sync point. Returns true when the store was reordered, pointers into it have to be
+// looked up again by id.
+bool entity_reorder_update() {
+    EntityReorder* reorder = &i_entity_data->reorder;
+    reorder->ticks_since++;
+
+    bool fragmented =
+        reorder->frees_since > 0 && reorder->frees_since * ENTITY_REORDER_FREE_FRACTION >= i_entity_data->entity_count;
+    if (reorder->ticks_since < ENTITY_REORDER_INTERVAL_TICKS && !fragmented) {
+        return false;
+    }
+
+    entity_reorder_spatially();
+
+    return true;
+}
+
+// NOTE: resolved per type by entity_init whenever the game code is loaded
+static Collider i_entity_colliders[ENTITY_TYPE_COUNT];
 
 Collider entity_collider_from_sprite(SpriteID sprite_id, ColliderAdjustments adjustments) {
     Vec2 sprite_world_size = sprite_get_world_size(sprite_id);
@@ -68,38 +355,41 @@ Collider entity_collider_from_sprite(SpriteID sprite_id, ColliderAdjustments adj
     return result;
 }
 
-Collider entity_collider_from_sprite(SpriteID sprite_id) {
-    return entity_collider_from_sprite(sprite_id, {});
-}
-
-void entity_init(EntityData* entity_data) {
-    i_entity_data = entity_data;
-
-    entity_info[ENTITY_TYPE_UNKNOWN] = {
+// NOTE: constant data, nothing in it is computed at load time. Colliders are resolved from the default sprites and
+// their adjustments in entity_init.
+const EntityInfo entity_info[ENTITY_TYPE_COUNT] = {
+    [ENTITY_TYPE_UNKNOWN] = {
         .type_name_string = "Unknown",
-    };
-
-    entity_info[ENTITY_TYPE_PLAYER] = {.type_name_string = "Player",
-                                       .animations =
-                                           {
-                                               .idle = ANIM_HERO_IDLE,
-                                               .move = ANIM_HERO_MOVE_LEFT,
-                                               .move_down = ANIM_HERO_MOVE_DOWN,
-                                               .move_up = ANIM_HERO_MOVE_UP,
-                                               .death = ANIM_HERO_DEAD,
-                                           },
-                                       .default_sprite = SPRITE_HERO_IDLE_0,
-                                       .collider = entity_collider_from_sprite(SPRITE_HERO_IDLE_0, {.size_y = -0.5f}),
-                                       .inventory_capacity = HOTBAR_MAX_SLOTS,
-                                       .brain_type = BRAIN_TYPE_PLAYER};
-
-    entity_info[ENTITY_TYPE_GUN] = {
+    },
+
+    [ENTITY_TYPE_PLAYER] = {.instance_flags = ENTITY_F_KILLABLE | ENTITY_F_GETS_HUNGERY |
+                                              ENTITY_F_COLLECTS_ITEMS | ENTITY_F_CONTROLS_PARTY,
+                            .type_name_string = "Player",
+                            .animations =
+                                {
+                                    .idle = ANIM_HERO_IDLE,
+                                    .move = ANIM_HERO_MOVE_LEFT,
+                                    .move_down = ANIM_HERO_MOVE_DOWN,
+                                    .move_up = ANIM_HERO_MOVE_UP,
+                                    .death = ANIM_HERO_DEAD,
+                                },
+                            .default_sprite = SPRITE_HERO_IDLE_0,
+                            .collider_adjustments = {.size_y = -0.5f},
+                            .base_hp = MAX_HP_PLAYER,
+                            .inventory_capacity = HOTBAR_MAX_SLOTS,
+                            .brain_type = BRAIN_TYPE_PLAYER,
+                            .base_hunger = MAX_HUNGER_PLAYER,
+                            .party_capacity = 3},
+
+    [ENTITY_TYPE_GUN] = {
         .flags = ENTITY_INFO_F_PERSIST_IN_INVENTORY,
+        .instance_flags = ENTITY_F_ITEM | ENTITY_F_NONSPACIAL,
         .type_name_string = "Gun",
         .default_sprite = SPRITE_GUN_GREEN,
-    };
+    },
 
-    entity_info[ENTITY_TYPE_WARRIOR] = {
+    [ENTITY_TYPE_WARRIOR] = {
+        .instance_flags = ENTITY_F_KILLABLE,
         .type_name_string = "Warrior",
         .animations =
             {
@@ -109,74 +399,94 @@ void entity_init(EntityData* entity_data) {
                 .attack = ANIM_WARRIOR_ATTACK,
             },
         .default_sprite = SPRITE_WARRIOR_IDLE_0,
-    };
+        .base_hp = MAX_HP_WARRIOR,
+        .brain_type = BRAIN_TYPE_WARRIOR,
+        .spawn_animation = ANIM_WARRIOR_IDLE,
+    },
 
-    entity_info[ENTITY_TYPE_PROJECTILE] = {
+    [ENTITY_TYPE_PROJECTILE] = {
         .type_name_string = "Projectile",
         .default_sprite = SPRITE_GREEN_BULLET_1,
-    };
+    },
 
-    entity_info[ENTITY_TYPE_BLOCK] = {
+    [ENTITY_TYPE_BLOCK] = {
+        .flags = ENTITY_INFO_F_STATIC,
+        .instance_flags = ENTITY_F_BLOCKER,
         .type_name_string = "Block",
         .default_sprite = SPRITE_BLOCK_1,
-    };
-
-    entity_info[ENTITY_TYPE_BOAR] = {.type_name_string = "Boar",
-                                     .animations =
-                                         {
-                                             .idle = ANIM_BOAR_IDLE,
-                                             .move = ANIM_BOAR_WALK,
-                                             .death = ANIM_BOAR_2_DEATH,
-                                         },
-                                     .default_sprite = SPRITE_BOAR_IDLE_0,
-                                     .collider = entity_collider_from_sprite(SPRITE_BOAR_IDLE_0, {.size_y = -0.25f}),
-                                     .spawn_info = {.spawned_entity_type = ENTITY_TYPE_BOAR_MEAT,
-                                                    .damage_required_to_spawn = MAX_HP_BOAR,
-                                                    .spawn_chance = 1.0f}};
-
-    entity_info[ENTITY_TYPE_BOAR_MEAT] = {
+    },
+
+    [ENTITY_TYPE_BOAR] = {.instance_flags = ENTITY_F_KILLABLE,
+                          .type_name_string = "Boar",
+                          .animations =
+                              {
+                                  .idle = ANIM_BOAR_IDLE,
+                                  .move = ANIM_BOAR_WALK,
+                                  .death = ANIM_BOAR_2_DEATH,
+                              },
+                          .default_sprite = SPRITE_BOAR_IDLE_0,
+                          .collider_adjustments = {.size_y = -0.25f},
+                          .base_hp = MAX_HP_BOAR,
+                          .spawn_info = {.spawned_entity_type = ENTITY_TYPE_BOAR_MEAT,
+                                         .damage_required_to_spawn = MAX_HP_BOAR,
+                                         .spawn_chance = 1.0f},
+                          .brain_type = BRAIN_TYPE_BOAR},
+
+    [ENTITY_TYPE_BOAR_MEAT] = {
+        .instance_flags = ENTITY_F_ITEM | ENTITY_F_NONSPACIAL,
         .type_name_string = "Boar Meat",
         .default_sprite = SPRITE_BOAR_MEAT_RAW,
-    };
+    },
 
-    entity_info[ENTITY_TYPE_COAL_DEPOSIT] = {
+    [ENTITY_TYPE_COAL_DEPOSIT] = {
+        .flags = ENTITY_INFO_F_STATIC,
         .type_name_string = "Coal Deposit",
         .default_sprite = SPRITE_ORE_COAL_0,
         .instance_flags = ENTITY_F_KILLABLE | ENTITY_F_BLOCKER,
         .base_hp = BASE_HP_COAL_DEPOSIT,
-        .spawn_info = {.spawned_entity_type = ENTITY_TYPE_COAL, .damage_required_to_spawn = 3, .spawn_chance = 0.5f}};
+        .spawn_info = {.spawned_entity_type = ENTITY_TYPE_COAL, .damage_required_to_spawn = 3, .spawn_chance = 0.5f}},
 
-    entity_info[ENTITY_TYPE_COAL] = {.type_name_string = "Coal",
-                                     .default_sprite = SPRITE_COAL_1,
-                                     .instance_flags = ENTITY_F_ITEM | ENTITY_F_NONSPACIAL};
+    [ENTITY_TYPE_COAL] = {.type_name_string = "Coal",
+                          .default_sprite = SPRITE_COAL_1,
+                          .instance_flags = ENTITY_F_ITEM | ENTITY_F_NONSPACIAL},
 
-    entity_info[ENTITY_TYPE_IRON_DEPOSIT] = {
+    [ENTITY_TYPE_IRON_DEPOSIT] = {
+        .flags = ENTITY_INFO_F_STATIC,
         .type_name_string = "Iron Deposit",
         .default_sprite = SPRITE_ORE_IRON_0,
         .instance_flags = ENTITY_F_KILLABLE | ENTITY_F_BLOCKER,
         .base_hp = BASE_HP_COAL_DEPOSIT,
-        .spawn_info = {.spawned_entity_type = ENTITY_TYPE_IRON, .damage_required_to_spawn = 3, .spawn_chance = 0.5f}};
-
-    entity_info[ENTITY_TYPE_IRON] = {.type_name_string = "Iron",
-                                     .default_sprite = SPRITE_IRON_1,
-                                     .instance_flags = ENTITY_F_ITEM | ENTITY_F_NONSPACIAL};
-
-    entity_info[ENTITY_TYPE_PLANT_CORN] = {.type_name_string = "Corn Plant",
-                                           .default_sprite = SPRITE_PLANT_CORN_3,
-                                           .spawn_info = {.spawned_entity_type = ENTITY_TYPE_ITEM_CORN,
-                                                          .damage_required_to_spawn = MAX_HP_PLANT_CORN,
-                                                          .spawn_chance = 1.0f}};
-
-    entity_info[ENTITY_TYPE_ITEM_CORN] = {
-        .flags = ENTITY_INFO_F_FOOD, .type_name_string = "Corn", .default_sprite = SPRITE_ITEM_CORN, .hunger_gain = 3};
-
-    entity_info[ENTITY_TYPE_CHEST_IRON] = {
-        .flags = ENTITY_INFO_F_PLACEABLE,
+        .spawn_info = {.spawned_entity_type = ENTITY_TYPE_IRON, .damage_required_to_spawn = 3, .spawn_chance = 0.5f}},
+
+    [ENTITY_TYPE_IRON] = {.type_name_string = "Iron",
+                          .default_sprite = SPRITE_IRON_1,
+                          .instance_flags = ENTITY_F_ITEM | ENTITY_F_NONSPACIAL},
+
+    [ENTITY_TYPE_PLANT_CORN] = {.flags = ENTITY_INFO_F_STATIC,
+                                .instance_flags = ENTITY_F_KILLABLE,
+                                .type_name_string = "Corn Plant",
+                                .default_sprite = SPRITE_PLANT_CORN_3,
+                                .base_hp = MAX_HP_PLANT_CORN,
+                                .spawn_info = {.spawned_entity_type = ENTITY_TYPE_ITEM_CORN,
+                                               .damage_required_to_spawn = MAX_HP_PLANT_CORN,
+                                               .spawn_chance = 1.0f}},
+
+    [ENTITY_TYPE_ITEM_CORN] = {.flags = ENTITY_INFO_F_FOOD,
+                               .instance_flags = ENTITY_F_ITEM | ENTITY_F_NONSPACIAL,
+                               .type_name_string = "Corn",
+                               .default_sprite = SPRITE_ITEM_CORN,
+                               .hunger_gain = 3},
+
+    [ENTITY_TYPE_CHEST_IRON] = {
+        .flags = ENTITY_INFO_F_PLACEABLE | ENTITY_INFO_F_STATIC,
+        .instance_flags = ENTITY_F_BLOCKER | ENTITY_F_PLAYER_INTERACTABLE | ENTITY_F_KILLABLE,
         .type_name_string = "Iron Chest",
         .default_sprite = SPRITE_CHESTS_IRON_0,
-    };
+        .base_hp = 5,
+        .inventory_capacity = 8,
+    },
 
-    entity_info[ENTITY_TYPE_ROBOT_GATHERER] = {
+    [ENTITY_TYPE_ROBOT_GATHERER] = {
         .animations =
             {
                 .idle = ANIM_ROBOT_GATHERER_IDLE,
@@ -185,40 +495,43 @@ void entity_init(EntityData* entity_data) {
         .type_name_string = "Gatherer Robot",
         .description = "I can gather!",
         .default_sprite = SPRITE_ROBOT_GATHERER_IDLE_0,
-        .collider = entity_collider_from_sprite(SPRITE_ROBOT_GATHERER_IDLE_0, {.size_y = -0.6f, .offset_y = 0.5f}),
+        .collider_adjustments = {.offset_y = 0.5f, .size_y = -0.6f},
         .flags = ENTITY_INFO_F_PERSIST_IN_INVENTORY,
         .instance_flags = ENTITY_F_KILLABLE | ENTITY_F_COLLECTS_ITEMS | ENTITY_F_PLAYER_INTERACTABLE,
         .inventory_capacity = 4,
         .base_hp = MAX_HP_ROBOT_GATHERER,
-        .brain_type = BRAIN_TYPE_ROBOT_GATHERER};
+        .brain_type = BRAIN_TYPE_ROBOT_GATHERER},
 
-    entity_info[ENTITY_TYPE_LANDING_POD_YELLOW] = {
+    [ENTITY_TYPE_LANDING_POD_YELLOW] = {
+        .flags = ENTITY_INFO_F_STATIC,
         .instance_flags = ENTITY_F_PLAYER_INTERACTABLE | ENTITY_F_BLOCKER,
         .type_name_string = "Yellow Landing Pod",
         .default_sprite = SPRITE_LANDING_POD_YELLOW,
-        .collider = entity_collider_from_sprite(SPRITE_LANDING_POD_YELLOW,
-                                                {.size_x = -2.2, .size_y = -2.7, .offset_x = -.01f, .offset_y = 0.5f}),
-        .inventory_capacity = 8};
+        .collider_adjustments = {.offset_x = -.01f, .offset_y = 0.5f, .size_x = -2.2, .size_y = -2.7},
+        .inventory_capacity = 8},
 
-    entity_info[ENTITY_TYPE_ROBOTICS_FACTORY] = {
+    [ENTITY_TYPE_ROBOTICS_FACTORY] = {
         .type_name_string = "Robotics Factory",
         .description = "A factory for pumping out sick ass mechs.",
+        .flags = ENTITY_INFO_F_STATIC,
         .default_sprite = SPRITE_ROBOTICS_FACTORY,
         .instance_flags = ENTITY_F_PLAYER_INTERACTABLE | ENTITY_F_BLOCKER,
-        .collider = entity_collider_from_sprite(SPRITE_ROBOTICS_FACTORY,
-                                                {.size_x = -2.5, .size_y = -4, .offset_x = -0.7, .offset_y = 0.25}),
-        .inventory_capacity = 8};
-}
+        .collider_adjustments = {.offset_x = -0.7, .offset_y = 0.25, .size_x = -2.5, .size_y = -4},
+        .inventory_capacity = 8},
+};
 
-Collider entity_get_collider(EntityType type) {
-    EntityInfo* e_info = &entity_info[type];
-    Collider result = e_info->collider;
+// Called whenever the game code is loaded, it restores the statics a hot reload resets
+void entity_init(EntityData* entity_data) {
+    i_entity_data = entity_data;
 
-    if (result.size.x == 0 || result.size.y == 0) {
-        result = entity_collider_from_sprite(e_info->default_sprite);
+    for (int i = 0; i < ENTITY_TYPE_COUNT; i++) {
+        const EntityInfo* e_info = &entity_info[i];
+        i_entity_colliders[i] = entity_collider_from_sprite(e_info->default_sprite, e_info->collider_adjustments);
     }
+}
 
-    return result;
+Collider entity_get_collider(EntityType type) {
+    return i_entity_colliders[type];
 }
 
 WorldCollider entity_get_world_collider(Entity* entity) {
@@ -236,63 +549,51 @@ Sprite entity_get_default_sprite(EntityType type) {
     return sprite_table[entity_info[type].default_sprite];
 }
 
-Entity* entity_new() {
-    uint32 idx = i_entity_data->entity_count;
-    Entity* entity = &i_entity_data->entities[i_entity_data->entity_count++];
-    memset(entity, 0, sizeof(Entity));
-
-    ASSERT(i_entity_data->entity_count < MAX_ENTITIES, "MAX_ENTITIES has been reached!");
+float entity_collider_reach(EntityType type) {
+    Collider collider = entity_get_collider(type);
+    float reach_x = w_abs(collider.offset.x) + (collider.size.x / 2);
+    float reach_y = w_abs(collider.offset.y) + (collider.size.y / 2);
 
-    entity->id = i_entity_data->entity_ids[idx];
-    entity->z_index = 1;
-    entity->facing_direction = {1, 0};
-    entity->stack_size = 1;
+    return w_max(reach_x, reach_y);
+}
 
-    for (int i = 0; i < ENTITY_MAX_INVENTORY_SIZE; i++) {
-        entity->inventory.items[i].entity_handle.generation = -1;
-    }
+static void entity_bounds_update(uint32 idx, Entity* entity) {
+    EntityBounds* bounds = &i_entity_data->bounds;
+    Collider collider = i_entity_colliders[entity->type];
 
-    for (int i = 0; i < MAX_ENTITY_PARTY_SIZE; i++) {
-        entity->entity_party.handles[i].generation = -1;
-    }
+    float x = entity->position.x + collider.offset.x;
+    float y = entity->position.y + collider.offset.y;
 
-    return entity;
+    bounds->min_x[idx] = x - (collider.size.x / 2);
+    bounds->min_y[idx] = y - (collider.size.y / 2);
+    bounds->max_x[idx] = x + (collider.size.x / 2);
+    bounds->max_y[idx] = y + (collider.size.y / 2);
 }
 
-Entity* entity_find_first_of_type(EntityType type) {
-    for (int i = 0; i < i_entity_data->entity_count; i++) {
-        if (i_entity_data->entities[i].type == type) {
-            return &i_entity_data->entities[i];
-        }
-    }
+bool entity_bounds_overlap(uint32 idx, Rect rect) {
+    EntityBounds* bounds = &i_entity_data->bounds;
 
-    return NULL;
+    return rect.x - (rect.w / 2) <= bounds->max_x[idx] && rect.x + (rect.w / 2) >= bounds->min_x[idx] &&
+           rect.y - (rect.h / 2) <= bounds->max_y[idx] && rect.y + (rect.h / 2) >= bounds->min_y[idx];
 }
 
-void entity_free(uint32 id) {
-    EntityLookup* freed_lookup = &i_entity_data->entity_lookups[id];
+// Returns the world space hitbox of the entity's current animation frame, false if the frame has none
+bool entity_attack_hitbox(Entity* entity, Rect* hitbox) {
+    SpriteID sprite_id = w_animation_current_sprite(&entity->anim_state);
+    Rect anim_hitbox = hitbox_table[sprite_id];
 
-    uint32 last_idx = i_entity_data->entity_count - 1;
-    Entity* last_entity = &i_entity_data->entities[last_idx];
-    if (last_entity->id != id) {
-        i_entity_data->entities[freed_lookup->idx] = *last_entity;
-
-        i_entity_data->entity_ids[freed_lookup->idx] = last_entity->id;
-        i_entity_data->entity_ids[last_idx] = id;
-
-        EntityLookup* last_lookup = &i_entity_data->entity_lookups[last_entity->id];
-        last_lookup->idx = freed_lookup->idx;
-
-        freed_lookup->idx = last_idx;
+    if (!w_rect_has_area(anim_hitbox)) {
+        return false;
     }
 
-    freed_lookup->generation++;
+    anim_hitbox = w_rect_mult(anim_hitbox, 1.0 / BASE_PIXELS_PER_UNIT);
+    *hitbox = {entity->position.x + anim_hitbox.x, entity->position.y + anim_hitbox.y, anim_hitbox.w, anim_hitbox.h};
 
-    i_entity_data->entity_count--;
+    return true;
 }
 
 Entity* entity_find(EntityHandle handle) {
-    ASSERT(handle.id < MAX_ENTITIES, "Entity handle has id greater than max entities");
+    ASSERT(handle.id < i_entity_data->store.capacity, "Entity handle has id greater than the entity store capacity");
     Entity* entity = NULL;
 
     EntityLookup lookup = i_entity_data->entity_lookups[handle.id];
@@ -316,156 +617,355 @@ EntityHandle entity_to_handle(Entity* entity) {
     return handle;
 }
 
-bool entity_same(EntityHandle entity_a, EntityHandle entity_b) {
-    return entity_a.id == entity_b.id && entity_a.generation == entity_b.generation;
+// ~~~~~~~~~~~~~~~~~~~~~~~~ entity commands ~~~~~~~~~~~~~~~~~~~~~~~~ //
+
+static void entity_command_push(EntityCommand command) {
+    EntityCommandBuffer* commands = &i_entity_data->commands;
+
+    ASSERT(commands->count < i_entity_data->store.capacity * ENTITY_COMMANDS_PER_ENTITY,
+           "the entity command buffer is full!");
+
+    commands->commands[commands->count++] = command;
 }
 
-EntityHandle entity_create_blocker(EntityType type, Vec2 position, SpriteID sprite_id) {
-    Entity* entity = entity_new();
+// Starts recording structural changes, they are applied by entity_commands_flush
+void entity_commands_begin() {
+    EntityCommandBuffer* commands = &i_entity_data->commands;
+
+    ASSERT(!commands->recording && commands->staged_count == 0, "entity commands were not flushed");
+
+    commands->recording = true;
+}
+
+// The entity is skipped by rendering and collision right away and freed at the next flush
+void entity_mark_for_deletion(Entity* entity) {
+    if (is_set(entity->flags, ENTITY_F_MARK_FOR_DELETION)) {
+        return;
+    }
+
+    set(entity->flags, ENTITY_F_MARK_FOR_DELETION);
+    entity_mark_dirty(entity, ENTITY_DIRTY_LIFECYCLE);
+    entity_command_push({.type = ENTITY_COMMAND_DESTROY, .handle = entity_to_handle(entity)});
+}
+
+// For flags of an entity other than the one being updated, they change at the flush while recording
+void entity_command_set_flags(Entity* entity, flags set_flags, flags unset_flags) {
+    entity_mark_dirty(entity, ENTITY_DIRTY_LIFECYCLE);
+
+    if (!i_entity_data->commands.recording) {
+        set(entity->flags, set_flags);
+        unset(entity->flags, unset_flags);
+        return;
+    }
+
+    entity_command_push({.type = ENTITY_COMMAND_SET_FLAGS,
+                         .handle = entity_to_handle(entity),
+                         .set_flags = set_flags,
+                         .unset_flags = unset_flags});
+}
+
+// Commits another block of the entity store, the new ids start out free with a generation of 0. Returns false when the
+// store can't grow.
+bool entity_data_grow(EntityData* entity_data) {
+    uint32 first_id = entity_data->store.capacity;
+    if (!entity_store_grow(&entity_data->store)) {
+        return false;
+    }
+    uint32 count = entity_data->store.capacity - first_id;
+
+    for (uint32 i = first_id; i < entity_data->store.capacity; i++) {
+        entity_data->entity_ids[i] = i;
+        entity_data->entity_lookups[i] = {.idx = i, .generation = 0};
+    }
+
+    spatial_grid_clear_ids(&entity_data->spatial_grid, first_id, count);
+    static_grid_clear_ids(&entity_data->static_grid, first_id, count);
+
+    return true;
+}
+
+// The record every entity starts from before its type's prototype is applied
+static void entity_base_record(EntityType type, Entity* entity, EntityCold* cold) {
+    memset(entity, 0, sizeof(Entity));
+    memset(cold, 0, sizeof(EntityCold));
 
     entity->type = type;
-    entity->position = position;
-    entity->sprite_id = sprite_id;
+    entity->z_index = 1;
+    entity->facing_direction = {1, 0};
+    cold->stack_size = 1;
 
-    set(entity->flags, ENTITY_F_BLOCKER);
+    for (int i = 0; i < MAX_ENTITY_PARTY_SIZE; i++) {
+        cold->entity_party.handles[i].generation = -1;
+    }
 
-    return entity_to_handle(entity);
+    if (is_set(entity_info[type].flags, ENTITY_INFO_F_STATIC)) {
+        set(entity->flags, ENTITY_F_STATIC);
+    }
 }
 
-EntityHandle entity_create_resource(EntityType entity_type, Vec2 position, SpriteID sprite_id, uint32 hp, flags opts) {
-    Entity* entity = entity_new();
+// Fills in the instance state described by the type's EntityInfo
+static void entity_prototype_record(EntityType type, flags opts, Entity* entity, EntityCold* cold) {
+    const EntityInfo* e_info = &entity_info[type];
 
-    entity->type = entity_type;
-    entity->position = position;
-    entity->sprite_id = sprite_id;
+    entity_base_record(type, entity, cold);
+
+    entity->sprite_id = e_info->default_sprite;
+    entity->hp = e_info->base_hp;
+    set(entity->flags, e_info->instance_flags);
     set(entity->flags, opts);
-    set(entity->flags, ENTITY_F_KILLABLE);
-    entity->hp = hp;
 
-    return entity_to_handle(entity);
+    if (e_info->spawn_animation != ANIM_UNKNOWN) {
+        w_play_animation(e_info->spawn_animation, &entity->anim_state);
+    }
+
+    if (e_info->base_hunger > 0) {
+        cold->hunger = e_info->base_hunger;
+        cold->hunger_cooldown_s = HUNGER_TICK_COOLDOWN_S;
+    }
+
+    cold->entity_party.capacity = e_info->party_capacity;
+    cold->brain.type = e_info->brain_type;
 }
 
-EntityHandle entity_create_player(Vec2 position) {
-    Entity* entity = entity_new();
+// Makes sure count more entities fit, one slot is always kept free same as when the store had a fixed size. Returns
+// false when the store can't grow far enough, nothing should be spawned then.
+static bool entity_data_reserve(uint32 count) {
+    uint32 idx = i_entity_data->entity_count + i_entity_data->commands.staged_count;
+
+    while (idx + count >= i_entity_data->store.capacity) {
+        if (!entity_data_grow(i_entity_data)) {
+            return false;
+        }
+    }
 
-    EntityInfo* e_info = &entity_info[ENTITY_TYPE_PLAYER];
+    return true;
+}
 
-    entity->type = ENTITY_TYPE_PLAYER;
-    entity->position = position;
-    entity->facing_direction.x = 1;
-    entity->facing_direction.y = 0;
-    set(entity->flags, ENTITY_F_KILLABLE);
-    entity->hp = MAX_HP_PLAYER;
-    entity->hunger = MAX_HUNGER_PLAYER;
-    entity->hunger_cooldown_s = HUNGER_TICK_COOLDOWN_S;
-    set(entity->flags, ENTITY_F_GETS_HUNGERY);
-    set(entity->flags, ENTITY_F_COLLECTS_ITEMS);
-    set(entity->flags, ENTITY_F_CONTROLS_PARTY);
-    entity->inventory.capacity = e_info->inventory_capacity;
-    entity->brain.type = e_info->brain_type;
-    entity->entity_party.capacity = 3;
+// Static records go into the static grid, whose chunks hold a fixed number of bodies. Returns false when one of
+// positions lands in a full chunk, nothing should be spawned then.
+static bool entity_static_reserve(Entity* record, Vec2* positions, uint32 count) {
+    if (!is_set(record->flags, ENTITY_F_STATIC)) {
+        return true;
+    }
 
-    return entity_to_handle(entity);
+    return static_grid_has_room(&i_entity_data->static_grid, positions, count);
 }
 
-EntityHandle entity_create_chest(Vec2 position, flags opts) {
-    Entity* entity = entity_new();
+// Copies a prepared record into the next free slot and links it into the store's indices
+static Entity* entity_place(Entity* record, EntityCold* cold_record, Vec2 position) {
+    EntityCommandBuffer* commands = &i_entity_data->commands;
+    uint32 idx = i_entity_data->entity_count + commands->staged_count;
+    EntityType type = record->type;
 
-    SpriteID sprite_id = entity_info[ENTITY_TYPE_CHEST_IRON].default_sprite;
+    Entity* entity = &i_entity_data->entities[idx];
+    EntityCold* cold = &i_entity_data->cold[idx];
+    *entity = *record;
+    *cold = *cold_record;
 
-    entity->type = ENTITY_TYPE_CHEST_IRON;
+    entity->id = i_entity_data->entity_ids[idx];
     entity->position = position;
-    entity->sprite_id = sprite_id;
-    entity->inventory.capacity = 8;
-    entity->hp = 5;
+    entity->previous_position = position;
+    entity->previous_z_pos = entity->z_pos;
+    entity_mark_dirty(entity, ENTITY_DIRTY_ALL);
 
-    set(entity->flags, opts);
-    set(entity->flags, ENTITY_F_BLOCKER);
-    set(entity->flags, ENTITY_F_PLAYER_INTERACTABLE);
-    set(entity->flags, ENTITY_F_KILLABLE);
+    if (entity_info[type].inventory_capacity > 0) {
+        cold->inventory_id =
+            inventory_pool_alloc(&i_entity_data->inventory_pool, entity_info[type].inventory_capacity, entity->id);
+    }
 
-    return entity_to_handle(entity);
+    if (is_set(entity->flags, ENTITY_F_STATIC)) {
+        static_grid_insert(&i_entity_data->static_grid, entity->id, position, entity_collider_reach(type));
+    } else {
+        spatial_grid_insert(&i_entity_data->spatial_grid, entity->id, position, entity_collider_reach(type));
+    }
+    entity_bounds_update(idx, entity);
+    entity_type_list_add(type, entity->id);
+
+    // NOTE: fmix32 only maps 0 to 0, the one state w_rng_u32 can't leave
+    cold->brain.rng = w_fmix32(entity->id + 1);
+    if (cold->brain.type != BRAIN_TYPE_NONE) {
+        entity_brain_bucket_add(cold->brain.type, entity->id);
+    }
+
+    if (commands->recording) {
+        commands->staged_count++;
+        entity_command_push({.type = ENTITY_COMMAND_CREATE, .handle = entity_to_handle(entity)});
+    } else {
+        i_entity_data->entity_count++;
+    }
+
+    return entity;
 }
 
-EntityHandle entity_create_gun(Vec2 position) {
-    Entity* entity = entity_new();
+// Returns a blank entity of type, callers fill in the rest. Use entity_spawn for an entity built from its prototype.
+// Both return NULL when the store is full or a static entity's static grid chunk is.
+Entity* entity_new(EntityType type, Vec2 position) {
+    Entity record;
+    EntityCold cold_record;
+    entity_base_record(type, &record, &cold_record);
 
-    entity->type = ENTITY_TYPE_GUN;
-    entity->position = position;
-    set(entity->flags, ENTITY_F_NONSPACIAL);
-    set(entity->flags, ENTITY_F_ITEM);
-    entity->sprite_id = SPRITE_GUN_GREEN;
+    if (!entity_static_reserve(&record, &position, 1) || !entity_data_reserve(1)) {
+        return NULL;
+    }
 
-    return entity_to_handle(entity);
+    return entity_place(&record, &cold_record, position);
 }
 
-EntityHandle entity_create_boar(Vec2 position) {
-    Entity* entity = entity_new();
+Entity* entity_spawn(EntityType type, Vec2 position, flags opts) {
+    Entity record;
+    EntityCold cold_record;
+    entity_prototype_record(type, opts, &record, &cold_record);
 
-    entity->type = ENTITY_TYPE_BOAR;
-    entity->position = position;
+    if (!entity_static_reserve(&record, &position, 1) || !entity_data_reserve(1)) {
+        return NULL;
+    }
 
-    set(entity->flags, ENTITY_F_KILLABLE);
-    entity->hp = MAX_HP_BOAR;
+    return entity_place(&record, &cold_record, position);
+}
 
-    entity->brain.type = BRAIN_TYPE_BOAR;
+// Spawns count entities of type from its prototype, the record is built once and the store grows at most once.
+// Returns false without spawning any of them when the store or a static grid chunk is full.
+bool entity_spawn_batch(EntityType type, Vec2* positions, uint32 count) {
+    ASSERT(type != ENTITY_TYPE_PLAYER, "the player is unique and can't be batch spawned");
 
-    return entity_to_handle(entity);
+    Entity record;
+    EntityCold cold_record;
+    entity_prototype_record(type, 0, &record, &cold_record);
+
+    if (!entity_static_reserve(&record, positions, count) || !entity_data_reserve(count)) {
+        return false;
+    }
+
+    for (int i = 0; i < count; i++) {
+        entity_place(&record, &cold_record, positions[i]);
+    }
+
+    return true;
 }
 
-EntityHandle entity_create_warrior(Vec2 position) {
-    Entity* entity = entity_new();
+// NOTE: must be called after an entity's position changes so spatial queries and bounds stay correct
+void entity_spatial_update(Entity* entity) {
+    entity_mark_dirty(entity, ENTITY_DIRTY_TRANSFORM);
+
+    if (is_set(entity->flags, ENTITY_F_STATIC)) {
+        return;
+    }
+
+    spatial_grid_move(&i_entity_data->spatial_grid, entity->id, entity->position);
+    entity_bounds_update(i_entity_data->entity_lookups[entity->id].idx, entity);
+}
 
-    entity->type = ENTITY_TYPE_WARRIOR;
-    w_play_animation(ANIM_WARRIOR_IDLE, &entity->anim_state);
+// Moves an entity to position at height z_pos in one jump. The previous transform is set to the new one as well, so
+// rendering doesn't interpolate it across the distance.
+void entity_teleport(Entity* entity, Vec2 position, float z_pos) {
     entity->position = position;
-    set(entity->flags, ENTITY_F_KILLABLE);
-    entity->hp = MAX_HP_WARRIOR;
+    entity->z_pos = z_pos;
+    entity->previous_position = position;
+    entity->previous_z_pos = z_pos;
+    entity_spatial_update(entity);
+}
+
+void entity_wake(Entity* entity) {
+    unset(entity->flags, ENTITY_F_ASLEEP);
+    entity->resting_ticks = 0;
+}
 
-    entity->brain.type = BRAIN_TYPE_WARRIOR;
+// NOTE: a resting entity would not move if integrated, so once it has rested for ENTITY_SLEEP_TICKS it is skipped by
+// the movement phase until something gives it velocity or acceleration again
+void entity_update_sleep(Entity* entity) {
+    bool is_resting = entity->velocity.x == 0 && entity->velocity.y == 0 && entity->acceleration.x == 0 &&
+                      entity->acceleration.y == 0;
 
-    return entity_to_handle(entity);
+    if (!is_resting) {
+        entity_wake(entity);
+    } else if (!is_set(entity->flags, ENTITY_F_ASLEEP) && ++entity->resting_ticks >= ENTITY_SLEEP_TICKS) {
+        set(entity->flags, ENTITY_F_ASLEEP);
+    }
 }
 
-EntityHandle entity_create_projectile(Vec2 position, float rotation_rads, Vec2 velocity) {
-    Entity* entity = entity_new();
+void entity_free(uint32 id) {
+    EntityLookup* freed_lookup = &i_entity_data->entity_lookups[id];
 
-    entity->type = ENTITY_TYPE_PROJECTILE;
-    entity->sprite_id = SPRITE_GREEN_BULLET_STRETCHED_1;
-    entity->position = position;
-    entity->rotation_rads = rotation_rads;
-    entity->velocity = velocity;
+    ASSERT(i_entity_data->commands.staged_count == 0, "entities can't be freed while creates are staged");
 
-    return entity_to_handle(entity);
+    entity_mark_dirty_id(id, ENTITY_DIRTY_LIFECYCLE);
+
+    spatial_grid_remove(&i_entity_data->spatial_grid, id);
+    static_grid_remove(&i_entity_data->static_grid, id);
+    entity_type_list_remove(i_entity_data->entities[freed_lookup->idx].type, id);
+
+    EntityCold* freed_cold = &i_entity_data->cold[freed_lookup->idx];
+    inventory_pool_free(&i_entity_data->inventory_pool, freed_cold->inventory_id);
+    if (freed_cold->brain.type != BRAIN_TYPE_NONE) {
+        entity_brain_bucket_remove(freed_cold->brain.type, id);
+    }
+
+    uint32 last_idx = i_entity_data->entity_count - 1;
+    Entity* last_entity = &i_entity_data->entities[last_idx];
+    if (last_entity->id != id) {
+        i_entity_data->entities[freed_lookup->idx] = *last_entity;
+        i_entity_data->cold[freed_lookup->idx] = i_entity_data->cold[last_idx];
+
+        EntityBounds* bounds = &i_entity_data->bounds;
+        bounds->min_x[freed_lookup->idx] = bounds->min_x[last_idx];
+        bounds->min_y[freed_lookup->idx] = bounds->min_y[last_idx];
+        bounds->max_x[freed_lookup->idx] = bounds->max_x[last_idx];
+        bounds->max_y[freed_lookup->idx] = bounds->max_y[last_idx];
+
+        i_entity_data->entity_ids[freed_lookup->idx] = last_entity->id;
+        i_entity_data->entity_ids[last_idx] = id;
+
+        EntityLookup* last_lookup = &i_entity_data->entity_lookups[last_entity->id];
+        last_lookup->idx = freed_lookup->idx;
+
+        freed_lookup->idx = last_idx;
+    }
+
+    freed_lookup->generation++;
+
+    i_entity_data->entity_count--;
+    i_entity_data->reorder.frees_since++;
 }
 
-EntityHandle entity_create_boar_meat(Vec2 position) {
-    Entity* entity = entity_new();
+bool entity_same(EntityHandle entity_a, EntityHandle entity_b) {
+    return entity_a.id == entity_b.id && entity_a.generation == entity_b.generation;
+}
 
-    entity->type = ENTITY_TYPE_BOAR_MEAT;
-    entity->sprite_id = SPRITE_BOAR_MEAT_RAW;
-    entity->position = position;
+EntityHandle entity_create_projectile(Vec2 position, float rotation_rads, Vec2 velocity) {
+    Entity* entity = entity_new(ENTITY_TYPE_PROJECTILE, position);
+    if (!entity) {
+        return entity_null_handle;
+    }
 
-    set(entity->flags, ENTITY_F_ITEM);
-    set(entity->flags, ENTITY_F_NONSPACIAL);
+    entity->sprite_id = SPRITE_GREEN_BULLET_STRETCHED_1;
+    entity->rotation_rads = rotation_rads;
+    entity->velocity = velocity;
 
     return entity_to_handle(entity);
 }
 
 EntityHandle entity_create_item(EntityType type, Vec2 position) {
-    Entity* entity = entity_new();
+    Entity* entity = entity_new(type, position);
+    if (!entity) {
+        return entity_null_handle;
+    }
 
     SpriteID sprite_id = entity_info[type].default_sprite;
 
     ASSERT(sprite_id != SPRITE_UNKNOWN, "Item entities must have sprite specified in entity_sprites\n");
 
-    entity->type = type;
     entity->sprite_id = sprite_id;
-    entity->position = position;
 
     set(entity->flags, ENTITY_F_ITEM);
     set(entity->flags, ENTITY_F_NONSPACIAL);
 
+    // NOTE: items of static types (e.g. chests) still move
+    if (is_set(entity->flags, ENTITY_F_STATIC)) {
+        unset(entity->flags, ENTITY_F_STATIC);
+        static_grid_remove(&i_entity_data->static_grid, entity->id);
+        spatial_grid_insert(&i_entity_data->spatial_grid, entity->id, position, entity_collider_reach(type));
+    }
+
     return entity_to_handle(entity);
 }
 
@@ -475,8 +975,9 @@ void entity_spawn_item(EntityType entity_type, Vec2 source_position, GameState*
     EntityHandle entity_handle = entity_create_item(entity_type, source_position);
 
     Entity* item = entity_find(entity_handle);
-
-    ASSERT(item != NULL, "Tried to spawn invalid item entity");
+    if (!item) {
+        return;
+    }
 
     Vec2 random_point = random_point_near_position(source_position, 1, 1);
     Vec2 random_point_direction = w_vec_sub(random_point, source_position);
@@ -492,13 +993,15 @@ void entity_spawn_item(EntityType entity_type, Vec2 source_position, GameState*
 }
 
 void entity_deal_damage(Entity* target, float damage, GameState* game_state) {
+    entity_wake(target);
     target->hp = w_clamp_min(target->hp - damage, 0);
     target->damage_taken_tint_cooldown_s = ENTITY_DAMAGE_TAKEN_TINT_COOLDOWN_S;
+    entity_mark_dirty(target, ENTITY_DIRTY_VISUAL);
     EntityItemSpawnInfo spawn_info = entity_info[target->type].spawn_info;
-    target->damage_since_spawn += damage;
+    entity_cold(target)->damage_since_spawn += damage;
     if (spawn_info.spawned_entity_type != ENTITY_TYPE_UNKNOWN &&
-        target->damage_since_spawn >= spawn_info.damage_required_to_spawn) {
-        target->damage_since_spawn = 0;
+        entity_cold(target)->damage_since_spawn >= spawn_info.damage_required_to_spawn) {
+        entity_cold(target)->damage_since_spawn = 0;
         float spawn_roll = w_random_between(0, 1);
         if (spawn_roll <= spawn_info.spawn_chance) {
             entity_spawn_item(spawn_info.spawned_entity_type, target->position, game_state);
@@ -550,16 +1053,28 @@ Vec2 entity_held_item_position(Entity* owner, float* z_pos, float* z_index) {
 
 // ~~~~~~~~~~~~~~~~~~~~~~~~ entity animations ~~~~~~~~~~~~~~~~~~~~~~~~ //
 
-void entity_play_animation_with_direction(AnimationID animation_id, AnimationState* anim_state, Vec2 facing_direction,
-                                          uint32 anim_state_opts) {
-    if (facing_direction.x > 0) {
-        set(anim_state_opts, ANIMATION_STATE_F_FLIP_X);
+// Marks the entity ENTITY_DIRTY_VISUAL when the animation or its flip changes, not when it only advances a frame
+void entity_play_animation(Entity* entity, AnimationID animation_id, uint32 anim_state_opts) {
+    AnimationState previous = entity->anim_state;
+
+    w_play_animation(animation_id, &entity->anim_state, anim_state_opts);
+
+    if (entity->anim_state.animation_id != previous.animation_id || entity->anim_state.flags != previous.flags) {
+        entity_mark_dirty(entity, ENTITY_DIRTY_VISUAL);
     }
-    w_play_animation(animation_id, anim_state, anim_state_opts);
 }
 
-void entity_play_animation_with_direction(AnimationID animation_id, AnimationState* anim_state, Vec2 facing_direction) {
-    entity_play_animation_with_direction(animation_id, anim_state, facing_direction, 0);
+void entity_play_animation(Entity* entity, AnimationID animation_id) {
+    entity_play_animation(entity, animation_id, 0);
+}
+
+void entity_play_animation_with_direction(Entity* entity, AnimationID animation_id) {
+    uint32 anim_state_opts = 0;
+    if (entity->facing_direction.x > 0) {
+        set(anim_state_opts, ANIMATION_STATE_F_FLIP_X);
+    }
+
+    entity_play_animation(entity, animation_id, anim_state_opts);
 }
 
 // ~~~~~~~~~~~~~~~~~~~~~~~~ entity rendering ~~~~~~~~~~~~~~~~~~~~~~~~~~~ //
@@ -589,7 +1104,22 @@ Vec2 entity_sprite_world_position(SpriteID sprite_id, Vec2 entity_position, floa
     return sprite_position;
 }
 
-RenderQuad* entity_render(Entity* entity, RenderGroup* render_group) {
+// Called at the start of every sim tick, rendering interpolates from these to where the tick leaves the entities
+void entity_save_previous_transforms() {
+    for (int i = 0; i < i_entity_data->entity_count; i++) {
+        Entity* entity = &i_entity_data->entities[i];
+        entity->previous_position = entity->position;
+        entity->previous_z_pos = entity->z_pos;
+    }
+}
+
+// alpha is the fraction of a tick the frame is past the last one, 0 is the previous tick and 1 the current one
+Vec2 entity_interpolated_position(Entity* entity, float alpha) {
+    return {w_lerp(entity->previous_position.x, entity->position.x, alpha),
+            w_lerp(entity->previous_position.y, entity->position.y, alpha)};
+}
+
+RenderQuad* entity_render(Entity* entity, RenderGroup* render_group, float alpha) {
     ASSERT(entity->sprite_id != SPRITE_UNKNOWN || entity->anim_state.animation_id != ANIM_UNKNOWN,
            "Cannot determine entity sprite");
 
@@ -611,7 +1141,8 @@ RenderQuad* entity_render(Entity* entity, RenderGroup* render_group) {
         sprite_id = entity->sprite_id;
     }
 
-    Vec2 sprite_position = entity_sprite_world_position(sprite_id, entity->position, entity->z_pos,
+    Vec2 sprite_position = entity_sprite_world_position(sprite_id, entity_interpolated_position(entity, alpha),
+                                                        w_lerp(entity->previous_z_pos, entity->z_pos, alpha),
                                                         is_set(opts, RENDER_SPRITE_OPT_FLIP_X));
 
     quad = render_sprite(sprite_position, sprite_id, render_group,
@@ -634,81 +1165,39 @@ void entity_player_movement_animation_update(Entity* entity, Vec2 player_movemen
 
     if (w_vec_length(player_movement_vec) > 0) {
         if (disc_facing_direction.x != 0) {
-            entity_play_animation_with_direction(animations.move, &entity->anim_state, entity->facing_direction);
+            entity_play_animation_with_direction(entity, animations.move);
         } else if (disc_facing_direction.y > 0) {
-            w_play_animation(animations.move_up, &entity->anim_state);
+            entity_play_animation(entity, animations.move_up);
         } else {
-            w_play_animation(animations.move_down, &entity->anim_state);
+            entity_play_animation(entity, animations.move_down);
         }
     } else {
-        entity_play_animation_with_direction(animations.idle, &entity->anim_state, entity->facing_direction);
+        entity_play_animation_with_direction(entity, animations.idle);
     }
 }
 
 #define ENTITY_CREATE_F_ITEM (1 << 0)
 
 EntityHandle entity_create(EntityType type, Vec2 position, flags opts) {
-    EntityHandle entity_handle;
+    EntityHandle entity_handle = entity_null_handle;
     switch (type) {
-    case ENTITY_TYPE_GUN:
-        entity_create_gun(position);
-        break;
-    case ENTITY_TYPE_WARRIOR:
-        entity_create_warrior(position);
-        break;
-    case ENTITY_TYPE_BLOCK:
-        entity_create_blocker(ENTITY_TYPE_BLOCK, position, SPRITE_BLOCK_1);
-        break;
-    case ENTITY_TYPE_BOAR:
-        entity_create_boar(position);
-        break;
-    case ENTITY_TYPE_BOAR_MEAT:
-        entity_create_boar_meat(position);
-        break;
-    case ENTITY_TYPE_PLANT_CORN:
-        entity_create_resource(ENTITY_TYPE_PLANT_CORN, position, SPRITE_PLANT_CORN_3, MAX_HP_PLANT_CORN, 0);
-        break;
-    case ENTITY_TYPE_ITEM_CORN:
-        entity_create_item(ENTITY_TYPE_ITEM_CORN, position);
-        break;
     case ENTITY_TYPE_CHEST_IRON:
         if (is_set(opts, ENTITY_CREATE_F_ITEM)) {
-            entity_create_item(type, position);
+            entity_handle = entity_create_item(type, position);
         } else {
-            entity_create_chest(position, opts);
+            entity_handle = entity_to_handle(entity_spawn(type, position, opts));
         }
         break;
     case ENTITY_TYPE_PLAYER: {
-        bool player_exists = false;
-        for (int i = 0; i < i_entity_data->entity_count; i++) {
-            if (i_entity_data->entities[i].type == ENTITY_TYPE_PLAYER) {
-                player_exists = true;
-            }
-        }
-
-        if (!player_exists) {
-            entity_create_player(position);
+        if (entity_type_count(ENTITY_TYPE_PLAYER) == 0) {
+            entity_handle = entity_to_handle(entity_spawn(type, position, opts));
         }
         break;
     }
-    default: {
-        Entity* entity = entity_new();
-
-        EntityInfo* e_info = &entity_info[type];
-
-        entity->type = type;
-        entity->position = position;
-        entity->sprite_id = e_info->default_sprite;
-        entity->hp = e_info->base_hp;
-        entity->inventory.capacity = e_info->inventory_capacity;
-
-        set(entity->flags, e_info->instance_flags);
-        set(entity->flags, opts);
-        entity_handle = entity_to_handle(entity);
-
+    default:
+        entity_handle = entity_to_handle(entity_spawn(type, position, opts));
         break;
     }
-    }
 
     return entity_handle;
 }
@@ -721,11 +1210,15 @@ void entity_inventory_spawn_world_item(InventoryItem* item, Vec3 source_position
         Vec2 source_position_2d = {source_position.x, source_position.y};
         EntityHandle item_entity_handle = entity_create_item(item->entity_type, source_position_2d);
         item_entity = entity_find(item_entity_handle);
+        if (!item_entity) {
+            return;
+        }
         item_entity->z_pos = source_position.z;
         item_entity->z_index = z_index;
-        item_entity->stack_size = item->stack_size;
+        entity_cold(item_entity)->stack_size = item->stack_size;
+        set(item_entity->flags, ENTITY_F_ITEM_SPAWNING);
     } else {
-        unset(item_entity->flags, ENTITY_F_IN_INVENTORY);
+        entity_command_set_flags(item_entity, ENTITY_F_ITEM_SPAWNING, ENTITY_F_IN_INVENTORY);
     }
 
     Vec2 random_point = random_point_near_position(item_entity->position, 1, 1);
@@ -741,12 +1234,11 @@ void entity_inventory_spawn_world_item(InventoryItem* item, Vec3 source_position
     item_entity->velocity = w_vec_mult(velocity_direction, velocity_mag);
 
     item_entity->item_drop_pickup_cooldown_s = ITEM_DROP_PICKUP_COOLDOWN_S;
-    item_entity->z_pos = 0.0001;
+    // NOTE: an item coming out of an inventory was last drawn in the hand or not at all, it drops from the source
+    entity_teleport(item_entity, {source_position.x, source_position.y}, 0.0001f);
     item_entity->z_velocity = 10;
     item_entity->z_acceleration = -40;
 
-    set(item_entity->flags, ENTITY_F_ITEM_SPAWNING);
-
     item->entity_handle = entity_null_handle;
     item->stack_size = 0;
     item->entity_type = ENTITY_TYPE_UNKNOWN;
@@ -754,11 +1246,13 @@ void entity_inventory_spawn_world_item(InventoryItem* item, Vec3 source_position
 
 void entity_death(Entity* entity) {
     if (is_set(entity->flags, ENTITY_F_KILLABLE) && entity->hp <= 0) {
-        for (int i = 0; i < entity->inventory.capacity; i++) {
-            InventoryItem* item = &entity->inventory.items[i];
+        Inventory* inventory = entity_inventory(entity);
+        for (int i = 0; i < inventory->capacity; i++) {
+            InventoryItem* item = &inventory->items[i];
             if (item->entity_type != ENTITY_TYPE_UNKNOWN) {
                 Vec3 position = {entity->position.x, entity->position.y, 0.25f};
                 entity_inventory_spawn_world_item(item, position, entity->z_index, 0);
+                entity_mark_dirty(entity, ENTITY_DIRTY_INVENTORY);
             }
         }
 
@@ -769,10 +1263,10 @@ void entity_death(Entity* entity) {
             entity_inventory_spawn_world_item(&item, position, entity->z_index, 0);
         }
 
-        if (entity->brain.type != BRAIN_TYPE_NONE) {
-            entity->brain.ai_state = AI_STATE_DEAD;
+        if (entity_cold(entity)->brain.type != BRAIN_TYPE_NONE) {
+            entity_cold(entity)->brain.ai_state = AI_STATE_DEAD;
         } else {
-            set(entity->flags, ENTITY_F_MARK_FOR_DELETION);
+            entity_mark_for_deletion(entity);
         }
     }
 }
@@ -781,19 +1275,190 @@ EntityHandle entity_create(EntityType type, Vec2 position) {
     return entity_create(type, position, 0);
 }
 
-Entity* entity_closest_player_interactable(Entity* player) {
-    Entity* closest_interactable_entity = NULL;
-    float closest_distance = 1.1;
-    for (int i = 0; i < i_entity_data->entity_count; i++) {
-        Entity* entity = &i_entity_data->entities[i];
-        if (is_set(entity->flags, ENTITY_F_PLAYER_INTERACTABLE)) {
-            float distance = w_euclid_dist(player->position, entity->position);
-            if (distance <= closest_distance) {
-                closest_interactable_entity = entity;
-                closest_distance = distance;
-            }
+// ~~~~~~~~~~~~~~~~~~~~~~~~ entity queries ~~~~~~~~~~~~~~~~~~~~~~~~ //
+
+#define ENTITY_QUERY_MAX_NEAREST 16
+
+// NOTE: below this many entities of the filtered type, walking the type's list beats walking the grid cells
+#define ENTITY_QUERY_TYPE_LIST_MAX 32
+
+// Walks the dynamic grid, then the static grid. Queries for a rare type walk that type's list instead.
+struct EntityQueryIterator {
+    SpatialGridIterator dynamic_it;
+    StaticGridIterator static_it;
+    bool in_static;
+    bool by_type;
+    uint32 type_next;
+};
+
+static EntityQueryIterator entity_query_iterator(Vec2 min, Vec2 max, EntityType type) {
+    EntityQueryIterator it = {};
+
+    if (type != ENTITY_TYPE_UNKNOWN && entity_type_count(type) <= ENTITY_QUERY_TYPE_LIST_MAX) {
+        it.by_type = true;
+        it.type_next = i_entity_data->type_lists.heads[type];
+        return it;
+    }
+
+    it.dynamic_it = spatial_grid_iterator(&i_entity_data->spatial_grid, min, max);
+    it.static_it = static_grid_iterator(&i_entity_data->static_grid, min, max);
+
+    return it;
+}
+
+static bool entity_query_iterator_next(EntityQueryIterator* it, uint32* id) {
+    if (it->by_type) {
+        if (it->type_next == ENTITY_TYPE_LIST_NULL) {
+            return false;
+        }
+
+        *id = it->type_next;
+        it->type_next = i_entity_data->type_lists.next[*id];
+        return true;
+    }
+
+    if (!it->in_static) {
+        if (spatial_grid_iterator_next(&i_entity_data->spatial_grid, &it->dynamic_it, id)) {
+            return true;
+        }
+        it->in_static = true;
+    }
+
+    return static_grid_iterator_next(&i_entity_data->static_grid, i_entity_data, &it->static_it, id);
+}
+
+static bool entity_query_matches(EntityType type, flags entity_flags, EntityQueryFilter* filter) {
+    if ((entity_flags & filter->required_flags) != filter->required_flags ||
+        is_set(entity_flags, filter->excluded_flags)) {
+        return false;
+    }
+
+    return filter->type == ENTITY_TYPE_UNKNOWN || type == filter->type;
+}
+
+static bool entity_query_matches(Entity* entity, EntityQueryFilter* filter) {
+    return entity_query_matches(entity->type, entity->flags, filter);
+}
+
+// Returns every entity whose position is within radius of center, in no particular order
+uint32 entity_query_radius(Vec2 center, float radius, EntityQueryFilter filter, Entity** results, uint32 max_results) {
+    Vec2 min = {center.x - radius, center.y - radius};
+    Vec2 max = {center.x + radius, center.y + radius};
+
+    uint32 count = 0;
+    uint32 id;
+    EntityQueryIterator it = entity_query_iterator(min, max, filter.type);
+    while (entity_query_iterator_next(&it, &id) && count < max_results) {
+        Entity* entity = entity_from_id(id);
+        if (entity_query_matches(entity, &filter) && w_euclid_dist(center, entity->position) <= radius) {
+            results[count++] = entity;
+        }
+    }
+
+    return count;
+}
+
+// NOTE: ties go to the entity later in the store, same as the linear scans the queries replaced picked the last one
+static bool entity_query_nearer(float distance, uint32 idx, float other_distance, uint32 other_idx) {
+    return distance < other_distance || (distance == other_distance && idx > other_idx);
+}
+
+// Returns the ids of up to k entities within radius of center, closest first. With from_snapshot positions and flags
+// are read from the tick's snapshots.
+
+static uint32 entity_query_nearest_ids(Vec2 center, float radius, EntityQueryFilter* filter, uint32 k, uint32* ids,
+                                       bool from_snapshot) {
+    ASSERT(k <= ENTITY_QUERY_MAX_NEAREST, "entity_query_nearest k is larger than ENTITY_QUERY_MAX_NEAREST");
+
+    Vec2 min = {center.x - radius, center.y - radius};
+    Vec2 max = {center.x + radius, center.y + radius};
+
+    float distances[ENTITY_QUERY_MAX_NEAREST];
+    uint32 idxs[ENTITY_QUERY_MAX_NEAREST];
+    uint32 count = 0;
+    uint32 id;
+    EntityQueryIterator it = entity_query_iterator(min, max, filter->type);
+    while (entity_query_iterator_next(&it, &id)) {
+        Entity* entity = entity_from_id(id);
+        Vec2 position = entity->position;
+        flags entity_flags = entity->flags;
+        if (from_snapshot) {
+            position = i_entity_data->snapshots[id].position;
+            entity_flags = i_entity_data->snapshots[id].flags;
+        }
+
+        if (!entity_query_matches(entity->type, entity_flags, filter)) {
+            continue;
         }
+
+        float distance = w_euclid_dist(center, position);
+        uint32 idx = i_entity_data->entity_lookups[id].idx;
+        if (distance > radius || (count == k && !entity_query_nearer(distance, idx, distances[count - 1],
+                                                                      idxs[count - 1]))) {
+            continue;
+        }
+
+        // NOTE: insertion sort, k is expected to be small
+        int slot = count < k ? count++ : count - 1;
+        while (slot > 0 && entity_query_nearer(distance, idx, distances[slot - 1], idxs[slot - 1])) {
+            distances[slot] = distances[slot - 1];
+            idxs[slot] = idxs[slot - 1];
+            ids[slot] = ids[slot - 1];
+            slot--;
+        }
+
+        distances[slot] = distance;
+        idxs[slot] = idx;
+        ids[slot] = id;
     }
 
+    return count;
+}
+
+// Returns up to k entities within radius of center, closest first
+uint32 entity_query_nearest(Vec2 center, float radius, EntityQueryFilter filter, uint32 k, Entity** results) {
+    uint32 ids[ENTITY_QUERY_MAX_NEAREST];
+    uint32 count = entity_query_nearest_ids(center, radius, &filter, k, ids, false);
+
+    for (int i = 0; i < count; i++) {
+        results[i] = entity_from_id(ids[i]);
+    }
+
+    return count;
+}
+
+// entity_query_nearest for brains, it only reads so the AI phase can run it from any thread. Entities are matched
+// by their snapshot, the results only depend on the last tick.
+uint32 entity_snapshot_query_nearest(Vec2 center, float radius, EntityQueryFilter filter, uint32 k, uint32* ids) {
+    return entity_query_nearest_ids(center, radius, &filter, k, ids, true);
+}
+
+// Returns the first entity whose world collider overlaps rect, ignore can be NULL
+Entity* entity_query_first_overlapping(Rect rect, EntityQueryFilter filter, Entity* ignore) {
+    Vec2 min = {rect.x - (rect.w / 2), rect.y - (rect.h / 2)};
+    Vec2 max = {rect.x + (rect.w / 2), rect.y + (rect.h / 2)};
+
+    uint32 id;
+    EntityQueryIterator it = entity_query_iterator(min, max, filter.type);
+    while (entity_query_iterator_next(&it, &id)) {
+        uint32 idx = i_entity_data->entity_lookups[id].idx;
+        Entity* entity = &i_entity_data->entities[idx];
+        if (entity == ignore || !entity_query_matches(entity, &filter)) {
+            continue;
+        }
+
+        if (entity_bounds_overlap(idx, rect)) {
+            return entity;
+        }
+    }
+
+    return NULL;
+}
+
+Entity* entity_closest_player_interactable(Entity* player) {
+    Entity* closest_interactable_entity = NULL;
+    entity_query_nearest(player->position, 1.1, {.required_flags = ENTITY_F_PLAYER_INTERACTABLE}, 1,
+                         &closest_interactable_entity);
+
     return closest_interactable_entity;
 }
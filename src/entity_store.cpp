@@ -0,0 +1,57 @@
+#include "game.h"
+
+void entity_store_init(EntityStore* store, ReserveMemory* reserve_memory, CommitMemory* commit_memory) {
+    store->reserve_memory = reserve_memory;
+    store->commit_memory = commit_memory;
+    store->array_count = 0;
+    store->capacity = 0;
+}
+
+// Reserves base_size bytes followed by MAX_ENTITIES elements and points data at them, the region is committed along
+// with the rest of the store from then on and size, when given, is kept at the committed size. Regions are added
+// before the store first grows.
+void entity_store_add_region(EntityStore* store, void** data, long long* size, uint64 base_size,
+                             uint32 element_size) {
+    ASSERT(store->array_count < ENTITY_STORE_MAX_ARRAYS, "ENTITY_STORE_MAX_ARRAYS has been reached!");
+    ASSERT(store->capacity == 0, "entity store arrays have to be added before the store grows");
+
+    *data = store->reserve_memory(base_size + (uint64)MAX_ENTITIES * element_size);
+    ASSERT(*data, "failed to reserve entity store memory");
+
+    store->arrays[store->array_count++] = {
+        .data = data, .element_size = element_size, .base_size = base_size, .size = size};
+}
+
+// Reserves MAX_ENTITIES elements for the array and points data at them
+void entity_store_add_array(EntityStore* store, void** data, uint32 element_size) {
+    entity_store_add_region(store, data, NULL, 0, element_size);
+}
+
+// Commits the next ENTITY_STORE_BLOCK_SIZE entities of every array, the new elements are zeroed. Returns false and
+// keeps the capacity it had when MAX_ENTITIES has been reached or the memory couldn't be committed.
+bool entity_store_grow(EntityStore* store) {
+    uint32 capacity = store->capacity + ENTITY_STORE_BLOCK_SIZE;
+    if (capacity > MAX_ENTITIES) {
+        return false;
+    }
+
+    // NOTE: each array is committed from its base, which is page aligned, already committed pages are left as is.
+    // Arrays committed before a failed commit keep their pages, they are only used once a later grow succeeds.
+    for (int i = 0; i < store->array_count; i++) {
+        EntityStoreArray* array = &store->arrays[i];
+        if (!store->commit_memory(*array->data, array->base_size + (uint64)capacity * array->element_size)) {
+            return false;
+        }
+    }
+
+    store->capacity = capacity;
+
+    for (int i = 0; i < store->array_count; i++) {
+        EntityStoreArray* array = &store->arrays[i];
+        if (array->size) {
+            *array->size = array->base_size + (uint64)capacity * array->element_size;
+        }
+    }
+
+    return true;
+}
@@ -3,8 +3,19 @@
 #include "entity.h"
 
 #define MAX_SOUND_VARIATIONS 10
-#define MAX_ENTITIES 10000
-#define MAX_COLLISION_RULES 512
+// NOTE: every array indexed by entity id or index reserves MAX_ENTITIES worth of address space up front and commits it
+// ENTITY_STORE_BLOCK_SIZE entities at a time, see EntityStore
+#define MAX_ENTITIES (1 << 20)
+#define ENTITY_STORE_BLOCK_SIZE 4096
+// NOTE: the frame arena is committed with the entity store. On top of a fixed base it holds two main and two debug
+// render quads and the collision scratch of every entity the store has room for.
+#define FRAME_ARENA_BASE_SIZE Megabytes(10)
+#define FRAME_ARENA_BYTES_PER_ENTITY (4 * sizeof(RenderQuad) + COLLISION_SCRATCH_BYTES_PER_ENTITY)
+// NOTE: the collision rule table starts at COLLISION_RULE_MIN_SLOTS and doubles up to COLLISION_RULE_MAX_SLOTS, both
+// powers of two
+#define COLLISION_RULE_MIN_SLOTS 8192
+#define COLLISION_RULE_MAX_SLOTS (1 << 24)
+#define COLLISION_RULE_BLOCK_SIZE 256
 
 #define MAX_DECORATIONS 5000
 
@@ -15,8 +26,6 @@
 #define MAX_PROJECTILE_DISTANCE 80
 #define ENTITY_MAX_Z 100
 
-#define ENTITY_MAX_INVENTORY_SIZE 32
-
 #define HOTBAR_MAX_SLOTS 8
 #define MAX_ITEM_STACK_SIZE 99
 
@@ -35,8 +44,10 @@
 
 #define ENTITY_DAMAGE_TAKEN_TINT_COOLDOWN_S 0.5f
 
+// NOTE: attack ids have the high bit set so they never overlap entity ids, collision rules are keyed by both
+#define ATTACK_ID_BIT 0x80000000
 #define ATTACK_ID_MAX_IDS 512
-#define ATTACK_ID_START (MAX_ENTITIES - 1)
+#define ATTACK_ID_START ATTACK_ID_BIT
 #define ATTACK_ID_LAST (ATTACK_ID_START + ATTACK_ID_MAX_IDS - 1)
 
 #define FOURCC(a, b, c, d) ((uint32)(a) << 24 | (uint32)(b) << 16 | (uint32)(c) << 8 | (uint32)(d))
@@ -100,7 +111,129 @@ struct CollisionRule {
     uint32 a_id;
     uint32 b_id;
     bool should_collide;
-    CollisionRule* next_rule;
+    // NOTE: every rule is linked into the rule list of both of its ids, a_next doubles as the free list link
+    CollisionRule* a_next;
+    CollisionRule* a_prev;
+    CollisionRule* b_next;
+    CollisionRule* b_prev;
+};
+
+struct CollisionRuleStats {
+    uint32 live;
+    uint32 peak;
+    uint32 capacity;
+};
+
+// Open addressed (linear probing) table of rules. Before it passes 3/4 full it is rehashed into the spare slot array
+// at twice the size and the two arrays swap, both are reserved for COLLISION_RULE_MAX_SLOTS up front.
+struct CollisionRules {
+    CollisionRule** slots;
+    CollisionRule** spare_slots;
+    uint32 slot_count;
+    CollisionRule** entity_rules;
+    CollisionRule* attack_rules[ATTACK_ID_MAX_IDS];
+    CollisionRule* free_list;
+    CollisionRuleStats stats;
+};
+
+struct CollisionStats {
+    uint32 broadphase_candidates;
+    uint32 pairs_tested;
+    uint32 attack_hitboxes;
+    uint32 bodies_awake;
+    uint32 bodies_asleep;
+    uint32 projectile_cells_marched;
+};
+
+// Marks which entity indices a projectile march has already tested, a slot is visited when it equals stamp
+struct CollisionVisitStamps {
+    uint32* stamps;
+    uint32 stamp;
+};
+
+// SoA of the targets a moving entity is tested against in one collision attempt
+struct CollisionTargets {
+    float* min_x;
+    float* min_y;
+    float* max_x;
+    float* max_y;
+    float* delta_x;
+    float* delta_y;
+    uint32* idx;
+    uint32 count;
+};
+
+// An animation hitbox that was active this tick, resolved against targets after every entity has moved.
+// attacker_idx is the attacker's place in the entity loop, it tells which targets had already moved when it swung.
+struct AttackHitbox {
+    uint32 attacker_id;
+    uint32 attacker_idx;
+    uint32 attack_id;
+    Rect rect;
+};
+
+#define COLLISION_BROADPHASE_NONE 0xFFFFFFFF
+#define COLLISION_BROADPHASE_BATCH_SIZE 256
+
+// First attempt candidates of the moving bodies, gathered by jobs before the movement phase and indexed by entity idx.
+// A body that wasn't gathered has a count of COLLISION_BROADPHASE_NONE.
+struct CollisionBroadphase {
+    uint32** candidates;
+    uint32* counts;
+    Vec2* box_min;
+    Vec2* box_max;
+    uint32 entity_count;
+    uint32 staged_count;
+};
+
+// Per tick scratch memory of the movement and attack hitbox phases
+struct CollisionScratch {
+    uint32* candidates;
+    CollisionBroadphase broadphase;
+    CollisionTargets targets;
+    AttackHitbox* attack_hitboxes;
+    uint32 attack_hitbox_count;
+    uint32* attack_kills; // ids of targets the hitboxes killed that the entity loop hadn't reached yet
+    uint32 attack_kill_count;
+    uint32 capacity;
+};
+
+#define COLLISION_SCRATCH_BYTES_PER_ENTITY                                                                            \
+    (4 * sizeof(uint32) + sizeof(uint32*) + 2 * sizeof(Vec2) + 6 * sizeof(float) + sizeof(AttackHitbox))
+
+// NOTE: cells cover the default 256x256 world, positions outside of it are clamped into the edge cells
+#define SPATIAL_GRID_CELL_DIMENSION 4
+#define SPATIAL_GRID_DIMENSION 64
+#define SPATIAL_GRID_CELL_COUNT (SPATIAL_GRID_DIMENSION * SPATIAL_GRID_DIMENSION)
+#define SPATIAL_GRID_NULL 0xFFFFFFFF
+
+// Entities are bucketed by position into a single cell. Queries are widened by max_reach, which is the furthest any
+// inserted collider extends from its entity position.
+struct SpatialGrid {
+    uint32 cell_heads[SPATIAL_GRID_CELL_COUNT];
+    uint32* next;
+    uint32* prev;
+    uint32* cells;
+    float max_reach;
+};
+
+struct SpatialGridIterator {
+    int min_col;
+    int max_col;
+    int max_row;
+    int row;
+    int col;
+    uint32 id;
+};
+
+// Steps a segment through the cell boundaries it crosses, t is the fraction of the segment
+struct SpatialGridRay {
+    double t;
+    double t_next_x;
+    double t_next_y;
+    double t_step_x;
+    double t_step_y;
+    bool done;
 };
 
 enum ColliderShape {
@@ -138,9 +271,23 @@ enum AIState {
     AI_STATE_HARVESTING
 };
 
-enum BrainType { BRAIN_TYPE_NONE, BRAIN_TYPE_PLAYER, BRAIN_TYPE_BOAR, BRAIN_TYPE_WARRIOR, BRAIN_TYPE_ROBOT_GATHERER };
+enum BrainType {
+    BRAIN_TYPE_NONE,
+    BRAIN_TYPE_PLAYER,
+    BRAIN_TYPE_BOAR,
+    BRAIN_TYPE_WARRIOR,
+    BRAIN_TYPE_ROBOT_GATHERER,
+    BRAIN_TYPE_COUNT
+};
 
 #define BRAIN_F_SEARCHING_INITIALIZED (1 << 0)
+#define BRAIN_F_THINKING (1 << 1) // picked by the scheduler to think this tick
+
+// Effects a brain has on other entities or shared state. Brains think in parallel, so they only record these and the
+// AI phase applies them afterwards in bucket order.
+#define BRAIN_INTENT_F_ATTACK_START (1 << 0) // takes the next attack id
+#define BRAIN_INTENT_F_ATTACK_END (1 << 1)   // drops the collision rules of the finished attack
+#define BRAIN_INTENT_F_HARVEST (1 << 2)      // deals a point of damage to target_handle
 
 #define BRAIN_HARVESTING_COOLDOWN_S 1.0f;
 
@@ -156,6 +303,12 @@ struct Brain {
     Vec2 searching_direction;
     Vec2 searching_target_position;
     float harvesting_cooldown_s;
+
+    uint32 intents;
+    uint32 rng; // seeded from the entity id, so the rolls don't depend on which thread thinks for it
+
+    float think_elapsed_s; // sim time since the brain last thought
+    float steer_speed;     // speed the last think moved towards target_position at, 0 when it stopped
 };
 
 enum DecorationType { DECORATION_TYPE_NONE, DECORATION_TYPE_PLANT };
@@ -188,9 +341,36 @@ struct InventoryItem {
     uint32 stack_size;
 };
 
+#define INVENTORY_NO_OWNER 0xFFFFFFFF
+
+// A view of an inventory's slots. Entity inventories point into InventoryPool, UI inventories into the frame arena.
+// owner_id is the id of the entity the slots belong to, changes to them mark it ENTITY_DIRTY_INVENTORY.
 struct Inventory {
-    InventoryItem items[ENTITY_MAX_INVENTORY_SIZE];
+    InventoryItem* items;
     uint32 capacity;
+    uint32 size_class;
+    uint32 owner_id;
+};
+
+// NOTE: slots are handed out in power of two size classes of 4 to 128 slots. Freed blocks are kept in a free list
+// per class, the first item of a free block stores the offset of the next free block in its stack_size.
+#define INVENTORY_POOL_MAX_INVENTORIES 1024
+#define INVENTORY_POOL_MAX_ITEMS (16 * 1024)
+#define INVENTORY_POOL_MIN_CLASS_SLOTS 4
+#define INVENTORY_POOL_SIZE_CLASS_COUNT 6
+#define INVENTORY_MAX_CAPACITY (INVENTORY_POOL_MIN_CLASS_SLOTS << (INVENTORY_POOL_SIZE_CLASS_COUNT - 1))
+#define INVENTORY_POOL_NULL 0xFFFFFFFF
+
+// Inventory 0 is the empty inventory that every entity without storage refers to
+struct InventoryPool {
+    Inventory inventories[INVENTORY_POOL_MAX_INVENTORIES];
+    uint32 inventory_count;
+    uint32 free_ids[INVENTORY_POOL_MAX_INVENTORIES];
+    uint32 free_id_count;
+
+    InventoryItem items[INVENTORY_POOL_MAX_ITEMS];
+    uint32 items_used;
+    uint32 free_blocks[INVENTORY_POOL_SIZE_CLASS_COUNT];
 };
 
 #define ENTITY_F_MARK_FOR_DELETION (1 << 0)
@@ -206,7 +386,14 @@ struct Inventory {
 #define ENTITY_F_GETS_HUNGERY (1 << 10)
 #define ENTITY_F_COLLECTS_ITEMS (1 << 11)
 #define ENTITY_F_CONTROLS_PARTY (1 << 12)
+#define ENTITY_F_STATIC (1 << 13)
+#define ENTITY_F_ASLEEP (1 << 14)
+
+// NOTE: ticks an entity has to rest (no velocity or acceleration) for before it is put to sleep
+#define ENTITY_SLEEP_TICKS 10
 
+// NOTE: Entity only holds what the per tick movement, collision and render loops touch, everything else lives in
+// EntityCold at the same index of EntityData, see entity_cold
 struct Entity {
     flags flags;
 
@@ -227,35 +414,257 @@ struct Entity {
 
     Vec2 facing_direction;
 
-    EntityParty entity_party;
-
     // projectile
     float distance_traveled;
 
     uint32 hp;
-    uint32 hunger;
-    float hunger_cooldown_s;
     float damage_taken_tint_cooldown_s;
     float item_drop_pickup_cooldown_s;
     uint32 attack_id;
 
     float item_floating_anim_timer_s;
 
+    // sleeping
+    uint32 resting_ticks;
+
+    // interpolation, where the entity was at the start of the last sim tick
+    Vec2 previous_position;
+    float previous_z_pos;
+};
+
+struct EntityCold {
+    EntityParty entity_party;
+
+    uint32 hunger;
+    float hunger_cooldown_s;
+
     // item spawning
     float damage_since_spawn;
 
-    Inventory inventory;
+    uint32 inventory_id;
 
     uint32 stack_size;
 
     Brain brain;
 };
 
+// NOTE: static bodies are bucketed per spawn chunk of the default 256x256 world, positions outside of it are clamped
+// into the edge chunks. Each chunk is re-sorted into cells only after a static body in it was added or removed.
+#define STATIC_GRID_CHUNKS_WIDE 4
+#define STATIC_GRID_CHUNK_COUNT (STATIC_GRID_CHUNKS_WIDE * STATIC_GRID_CHUNKS_WIDE)
+#define STATIC_GRID_CHUNK_CELLS_WIDE 8
+#define STATIC_GRID_CHUNK_CELL_COUNT (STATIC_GRID_CHUNK_CELLS_WIDE * STATIC_GRID_CHUNK_CELLS_WIDE)
+#define STATIC_GRID_CELL_DIMENSION (SPAWN_CHUNK_DIMENSION / STATIC_GRID_CHUNK_CELLS_WIDE)
+#define STATIC_GRID_DIMENSION (STATIC_GRID_CHUNKS_WIDE * STATIC_GRID_CHUNK_CELLS_WIDE)
+#define STATIC_GRID_MAX_PER_CHUNK 4096
+
+struct StaticGridChunk {
+    bool dirty;
+    uint32 count;
+    uint32 ids[STATIC_GRID_MAX_PER_CHUNK];
+
+    // rebuilt from ids when dirty, sorted by cell
+    uint32 cell_start[STATIC_GRID_CHUNK_CELL_COUNT + 1];
+    uint32 sorted_ids[STATIC_GRID_MAX_PER_CHUNK];
+    float min_x[STATIC_GRID_MAX_PER_CHUNK];
+    float min_y[STATIC_GRID_MAX_PER_CHUNK];
+    float max_x[STATIC_GRID_MAX_PER_CHUNK];
+    float max_y[STATIC_GRID_MAX_PER_CHUNK];
+};
+
+struct StaticGrid {
+    StaticGridChunk chunks[STATIC_GRID_CHUNK_COUNT];
+    uint32* chunk_of;
+    uint32* slot_of;
+    float max_reach;
+    uint32 count;
+    uint32 rebuilds;
+};
+
+struct StaticGridIterator {
+    int min_col;
+    int max_col;
+    int max_row;
+    int row;
+    int col;
+    StaticGridChunk* chunk;
+    uint32 at;
+    uint32 end;
+};
+
+// World space collider AABBs, indexed the same as EntityData::entities
+struct EntityBounds {
+    float* min_x;
+    float* min_y;
+    float* max_x;
+    float* max_y;
+};
+
+// Dense lists of entity ids per brain type, so the AI phase runs one brain function over a whole bucket. slots maps
+// an entity id to its position in its bucket for swap-removes.
+struct BrainBucket {
+    uint32* ids;
+    uint32 count;
+};
+
+struct BrainBuckets {
+    BrainBucket buckets[BRAIN_TYPE_COUNT];
+    uint32* slots;
+};
+
+#define BRAIN_JOB_BATCH_SIZE 512
+#define BRAIN_THINK_BUDGET 512
+
+// Spreads the thinks of the boar, warrior and robot brains over ticks. A brain is due once its type's think interval
+// has passed and steers towards its cached target in between. Due brains that don't fit the tick's budget are
+// deferred and go first next tick. NOTE: the budget counts thinks rather than time so which brains think only depends
+// on the sim state, a budget of 0 lets every due brain think.
+struct BrainScheduler {
+    uint32 think_budget;                   // thinks per tick
+    uint32 cursors[BRAIN_TYPE_COUNT];      // bucket slot each type's round robin resumes at
+    uint32 first_type;                     // rotates which type gets the budget first
+    float think_cost_us[BRAIN_TYPE_COUNT]; // running average of one think for tuning the budget, 0 until measured
+    uint32 thinks;                         // last tick
+    uint32 deferred;                       // last tick
+    uint64 deferred_total;
+};
+
+#define ENTITY_DIRTY_TRANSFORM (1 << 0) // position changed
+#define ENTITY_DIRTY_VISUAL (1 << 1)    // animation, sprite or damage tint changed
+#define ENTITY_DIRTY_INVENTORY (1 << 2) // items were added to, removed from or moved out of its inventory
+#define ENTITY_DIRTY_LIFECYCLE (1 << 3) // created, marked for deletion, freed or moved in or out of an inventory
+#define ENTITY_DIRTY_ALL \
+    (ENTITY_DIRTY_TRANSFORM | ENTITY_DIRTY_VISUAL | ENTITY_DIRTY_INVENTORY | ENTITY_DIRTY_LIFECYCLE)
+
+// What changed about each entity since the last entity_dirty_clear. bits is indexed by id, ids lists every id with
+// bits set once, in the order they were first marked, so consumers can process only the entities that changed.
+struct EntityDirtySet {
+    uint8* bits;
+    uint32* ids;
+    uint32 count;
+};
+
+#define ENTITY_TYPE_LIST_NULL 0xFFFFFFFF
+
+// Intrusive lists of entity ids per type with live counts. An entity's type is fixed by entity_new, so ids only
+// join a list when created and leave it when freed.
+struct EntityTypeLists {
+    uint32 heads[ENTITY_TYPE_COUNT];
+    uint32 counts[ENTITY_TYPE_COUNT];
+    uint32* next;
+    uint32* prev;
+};
+
+#define ENTITY_COMMANDS_PER_ENTITY 2
+
+enum EntityCommandType { ENTITY_COMMAND_CREATE, ENTITY_COMMAND_DESTROY, ENTITY_COMMAND_SET_FLAGS };
+
+struct EntityCommand {
+    EntityCommandType type;
+    EntityHandle handle;
+    flags set_flags;
+    flags unset_flags;
+};
+
+// Structural changes requested while entities are being updated. Entities created while recording are staged past
+// entity_count, so the update loop doesn't reach them until the flush. Destroys and flag changes wait for the flush
+// and are applied in the order they were recorded.
+struct EntityCommandBuffer {
+    EntityCommand* commands;
+    uint32 count;
+    uint32 staged_count;
+    bool recording;
+};
+
+#define ENTITY_REORDER_INTERVAL_TICKS 600
+#define ENTITY_REORDER_FREE_FRACTION 8 // reorder early once entity_count / 8 entities were swap removed
+#define ENTITY_REORDER_DONE_BIT 0x80000000
+#define ENTITY_REORDER_IDX_MASK 0x7FFFFFFF
+
+// Frees swap remove and entities wander, so over time neighbours in the world end up far apart in the store. Every so
+// often the store is sorted by the morton code of each entity's cell so neighbourhood queries touch nearby memory.
+struct EntityReorder {
+    uint64* keys; // morton code in the high half, the index it sorts into the low half
+    uint32 ticks_since;
+    uint32 frees_since;
+    uint32 reorder_count;
+};
+
+#define ENTITY_STORE_MAX_ARRAYS 32
+
+struct EntityStoreArray {
+    void** data;
+    uint32 element_size;
+    uint64 base_size; // bytes ahead of the elements
+    long long* size;  // kept at the committed size when set
+};
+
+// Entity arrays grow in place inside their reserved ranges, so pointers into them stay valid as the store grows and
+// iterating them costs the same as iterating a fixed array
+struct EntityStore {
+    ReserveMemory* reserve_memory;
+    CommitMemory* commit_memory;
+    EntityStoreArray arrays[ENTITY_STORE_MAX_ARRAYS];
+    uint32 array_count;
+    uint32 capacity;
+};
+
+// What brains see of an entity, indexed by id. Copied at the start of every tick so the AI phase reads the previous
+// tick whichever order the brains run in.
+struct EntitySnapshot {
+    Vec2 position;
+    uint32 hp;
+    flags flags;
+};
+
 struct EntityData {
-    Entity entities[MAX_ENTITIES];
+    EntityStore store;
+    Entity* entities;
+    EntityCold* cold;
     uint32 entity_count;
-    uint32 entity_ids[MAX_ENTITIES];
-    EntityLookup entity_lookups[MAX_ENTITIES];
+    uint32* entity_ids;
+    EntityLookup* entity_lookups;
+    SpatialGrid spatial_grid;
+    StaticGrid static_grid;
+    EntityBounds bounds;
+    InventoryPool inventory_pool;
+    BrainBuckets brain_buckets;
+    EntityTypeLists type_lists;
+    EntityDirtySet dirty;
+    EntityReorder reorder;
+    EntitySnapshot* snapshots;
+    EntityCommandBuffer commands;
+};
+
+struct EntityQueryFilter {
+    flags required_flags;
+    flags excluded_flags;
+    EntityType type; // ENTITY_TYPE_UNKNOWN matches every type
+};
+
+// NOTE: tiers are kept per spawn chunk of the default 256x256 world, positions outside of it are clamped into the
+// edge chunks. Near chunks step every tick, mid chunks step every SIM_LOD_MID_TICK_INTERVAL ticks with the time they
+// built up and far chunks only run a coarse step of timers and lifecycle every SIM_LOD_FAR_TICK_INTERVAL ticks.
+#define SIM_LOD_CHUNKS_WIDE 4
+#define SIM_LOD_CHUNK_COUNT (SIM_LOD_CHUNKS_WIDE * SIM_LOD_CHUNKS_WIDE)
+#define SIM_LOD_NEAR_CHUNK_RADIUS 1 // covers the camera wherever the player stands in its chunk
+#define SIM_LOD_MID_CHUNK_RADIUS 2  // the window proc_gen_update_chunk_states spawns in
+#define SIM_LOD_MID_TICK_INTERVAL 4
+#define SIM_LOD_FAR_TICK_INTERVAL 16
+
+enum SimLodTier { SIM_LOD_TIER_NEAR, SIM_LOD_TIER_MID, SIM_LOD_TIER_FAR, SIM_LOD_TIER_COUNT };
+
+struct SimLodChunk {
+    SimLodTier tier;
+    double accumulated_s; // sim time a mid or far chunk hasn't stepped yet
+    double dt_s;          // what the chunk's entities step this tick, 0 while they wait or are far
+    double coarse_dt_s;   // what a far chunk's entities run their coarse step over this tick, 0 while they wait
+};
+
+struct SimLod {
+    SimLodChunk chunks[SIM_LOD_CHUNK_COUNT];
+    uint32 tick_index;
+    uint32 tier_counts[SIM_LOD_TIER_COUNT];
 };
 
 struct HotBar {
@@ -270,6 +679,32 @@ struct WorldInput {
     Vec2 mouse_position_world;
 };
 
+struct PlayerInputAction {
+    bool is_held;
+    bool was_pressed;
+    bool was_released;
+    float held_duration_s;
+};
+
+struct PlayerInputWorld {
+    Vec2 movement_vec;
+    Vec2 aim_vec;
+    PlayerInputAction use_held_item;
+    PlayerInputAction interact;
+    PlayerInputAction open_inventory;
+    bool drop_item;
+};
+
+struct PlayerInputUI {
+    PlayerInputAction select;
+    PlayerInputAction close;
+};
+
+struct PlayerInput {
+    PlayerInputWorld world;
+    PlayerInputUI ui;
+};
+
 #define TOOLS_F_CAPTURING_KEYBOARD_INPUT (1 << 0)
 #define TOOLS_F_CAPTURING_MOUSE_INPUT (1 << 1)
 
@@ -282,6 +717,9 @@ struct Tools {
     bool draw_entity_positions;
     bool draw_hitboxes;
     bool disable_hunger;
+    bool disable_entity_reorder;
+    bool disable_sim_lod;
+    bool draw_sim_lod;
     float camera_zoom;
 };
 
@@ -294,7 +732,7 @@ struct WorldInitEntity {
     Vec2 position;
 };
 
-#define MAX_WORLD_ENTITY_INITS (MAX_ENTITIES / 2)
+#define MAX_WORLD_ENTITY_INITS 5000
 
 struct WorldInit {
     Vec2 world_size;
@@ -352,12 +790,13 @@ struct GameState {
     AudioPlayer audio_player;
     Sound sounds[SOUND_TYPE_COUNT];
     Arena main_arena;
-    Arena frame_arena;
+    Arena frame_arena; // committed with the entity store, see FRAME_ARENA_BYTES_PER_ENTITY
     FontData font_data;
     uint32 viewport_scale_factor;
     EntityData entity_data;
-    CollisionRule* collision_rule_hash[MAX_COLLISION_RULES];
-    CollisionRule* collision_rule_free_list;
+    CollisionRules collision_rules;
+    CollisionStats collision_stats;
+    CollisionVisitStamps collision_visits;
     Entity* player;
     Entity* command_center;
     HotBar hotbar;
@@ -368,7 +807,15 @@ struct GameState {
     TextureInfo font_texture_info;
     ChunkSpawn chunk_spawn;
     uint32 chunk_spawn_state_count;
+    SimLod sim_lod;
+    BrainScheduler brain_scheduler;
     UIMode ui_mode;
     Tools tools;
     RenderGroups render_groups;
+
+    // Frame time not yet simulated, the sim runs in whole ticks of g_sim_dt_s and rendering interpolates between the
+    // last two of them
+    double sim_accumulator_s;
+    uint32 sim_ticks_this_frame;
+    PlayerInput tick_input; // world input presses wait here until a tick has seen them
 };
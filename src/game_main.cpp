@@ -17,10 +17,16 @@ char* g_base_path;
 char* g_debug_project_dir;
 uint32 g_pixels_per_unit;
 double g_sim_dt_s;
+Jobs* g_jobs;
+GetPerformanceCounter* g_get_performance_counter;
+uint64 g_performance_frequency;
+// NOTE: statics start over whenever the game code is loaded, so this is false again after a hot reload
+bool g_game_code_loaded;
 
 #ifdef DEBUG
 RenderGroup* g_debug_render_group;
 DebugInfo* g_debug_info;
+GameMemory* debug_game_memory;
 #endif
 
 #define DEFAULT_WORLD_WIDTH 256
@@ -32,32 +38,6 @@ Vec2 get_world_top_left_tile_position() {
 
 #define DEFAULT_Z_INDEX 1.0f
 
-struct PlayerInputAction {
-    bool is_held;
-    bool was_pressed;
-    bool was_released;
-    float held_duration_s;
-};
-
-struct PlayerInputWorld {
-    Vec2 movement_vec;
-    Vec2 aim_vec;
-    PlayerInputAction use_held_item;
-    PlayerInputAction interact;
-    PlayerInputAction open_inventory;
-    bool drop_item;
-};
-
-struct PlayerInputUI {
-    PlayerInputAction select;
-    PlayerInputAction close;
-};
-
-struct PlayerInput {
-    PlayerInputWorld world;
-    PlayerInputUI ui;
-};
-
 Vec2 random_point_near_position(Vec2 position, float x_range, float y_range) {
     float random_x = w_random_between(-x_range, x_range);
     float random_y = w_random_between(-y_range, y_range);
@@ -66,6 +46,10 @@ Vec2 random_point_near_position(Vec2 position, float x_range, float y_range) {
     return result;
 }
 
+Vec2 random_point_near_position(Vec2 position, float x_range, float y_range, uint32* rng) {
+    return {position.x + w_rng_range_f32(rng, -x_range, x_range), position.y + w_rng_range_f32(rng, -y_range, y_range)};
+}
+
 #define RENDER_SPRITE_OPT_FLIP_X (1 << 0)
 #define RENDER_SPRITE_OPT_TINT_SET (1 << 1)
 
@@ -144,23 +128,6 @@ uint32 get_next_attack_id(uint32* attack_id_next) {
     return result;
 }
 
-// TODO: make this faster?
-void remove_collision_rules(uint32 id, CollisionRule** hash, CollisionRule** free_list) {
-    for (int i = 0; i < MAX_COLLISION_RULES; i++) {
-        for (CollisionRule** rule = &hash[i]; *rule;) {
-            if ((*rule)->a_id == id || (*rule)->b_id == id) {
-                CollisionRule* free_rule = *rule;
-                *rule = (*rule)->next_rule;
-
-                free_rule->next_rule = *free_list;
-                *free_list = &(*free_rule);
-            } else {
-                rule = &(*rule)->next_rule;
-            }
-        }
-    }
-}
-
 void create_decoration(DecorationData* decoration_data, DecorationType type, Vec2 position, SpriteID sprite_id) {
     Decoration* decorations = decoration_data->decorations;
     Decoration* decoration = NULL;
@@ -177,6 +144,10 @@ void create_decoration(DecorationData* decoration_data, DecorationType type, Vec
     decoration->type = type;
 }
 
+#include "entity_store.cpp"
+#include "spatial_grid.cpp"
+#include "sim_lod.cpp"
+#include "inventory_pool.cpp"
 #include "entity.cpp"
 #include "collision.cpp"
 #include "inventory.cpp"
@@ -201,19 +172,106 @@ Vec2 get_viewport(uint32 scale) {
     return {(float)scale * BASE_RESOLUTION_WIDTH, (float)scale * BASE_RESOLUTION_HEIGHT};
 }
 
-void init_entity_data(EntityData* entity_data) {
-    for (int i = 0; i < MAX_ENTITIES; i++) {
-        entity_data->entity_ids[i] = i;
+// Registers every array indexed by entity id or index with the entity store and commits the first block of it
+void init_entity_data(GameState* game_state, ReserveMemory* reserve_memory, CommitMemory* commit_memory) {
+    EntityData* entity_data = &game_state->entity_data;
+    EntityStore* store = &entity_data->store;
+
+    entity_store_init(store, reserve_memory, commit_memory);
+    entity_store_add_array(store, (void**)&entity_data->entities, sizeof(Entity));
+    entity_store_add_array(store, (void**)&entity_data->cold, sizeof(EntityCold));
+    entity_store_add_array(store, (void**)&entity_data->entity_ids, sizeof(uint32));
+    entity_store_add_array(store, (void**)&entity_data->entity_lookups, sizeof(EntityLookup));
+
+    entity_store_add_array(store, (void**)&entity_data->bounds.min_x, sizeof(float));
+    entity_store_add_array(store, (void**)&entity_data->bounds.min_y, sizeof(float));
+    entity_store_add_array(store, (void**)&entity_data->bounds.max_x, sizeof(float));
+    entity_store_add_array(store, (void**)&entity_data->bounds.max_y, sizeof(float));
+
+    entity_store_add_array(store, (void**)&entity_data->spatial_grid.next, sizeof(uint32));
+    entity_store_add_array(store, (void**)&entity_data->spatial_grid.prev, sizeof(uint32));
+    entity_store_add_array(store, (void**)&entity_data->spatial_grid.cells, sizeof(uint32));
+    entity_store_add_array(store, (void**)&entity_data->static_grid.chunk_of, sizeof(uint32));
+    entity_store_add_array(store, (void**)&entity_data->static_grid.slot_of, sizeof(uint32));
+
+    for (int i = 0; i < BRAIN_TYPE_COUNT; i++) {
+        entity_store_add_array(store, (void**)&entity_data->brain_buckets.buckets[i].ids, sizeof(uint32));
+        entity_data->brain_buckets.buckets[i].count = 0;
+    }
+    entity_store_add_array(store, (void**)&entity_data->brain_buckets.slots, sizeof(uint32));
+    entity_store_add_array(store, (void**)&entity_data->type_lists.next, sizeof(uint32));
+    entity_store_add_array(store, (void**)&entity_data->type_lists.prev, sizeof(uint32));
+    entity_store_add_array(store, (void**)&entity_data->dirty.bits, sizeof(uint8));
+    entity_store_add_array(store, (void**)&entity_data->dirty.ids, sizeof(uint32));
+    entity_data->dirty.count = 0;
+    entity_store_add_array(store, (void**)&entity_data->reorder.keys, sizeof(uint64));
+    entity_data->reorder = {.keys = entity_data->reorder.keys};
+    entity_store_add_array(store, (void**)&entity_data->snapshots, sizeof(EntitySnapshot));
+
+    entity_store_add_array(store, (void**)&entity_data->commands.commands,
+                           sizeof(EntityCommand) * ENTITY_COMMANDS_PER_ENTITY);
+
+    entity_store_add_array(store, (void**)&game_state->collision_rules.entity_rules, sizeof(CollisionRule*));
+    collision_rules_init(&game_state->collision_rules, store);
+    entity_store_add_array(store, (void**)&game_state->collision_visits.stamps, sizeof(uint32));
+
+    // NOTE: the frame arena holds render quads and collision scratch for every entity the store has room for
+    entity_store_add_region(store, (void**)&game_state->frame_arena.data, &game_state->frame_arena.size,
+                            FRAME_ARENA_BASE_SIZE, FRAME_ARENA_BYTES_PER_ENTITY);
+
+    spatial_grid_clear(&entity_data->spatial_grid);
+    static_grid_clear(&entity_data->static_grid);
+    inventory_pool_clear(&entity_data->inventory_pool);
+    entity_type_lists_clear(&entity_data->type_lists);
+
+    // NOTE: a store that can't commit its first block stays empty, spawns are refused until a grow succeeds
+    if (!entity_data_grow(entity_data)) {
+        printf("failed to commit the first entity store block\n");
+    }
+    game_state->frame_arena.next = game_state->frame_arena.data;
+}
 
-        EntityLookup* lookup = &entity_data->entity_lookups[i];
-        lookup->generation = 0;
-        lookup->idx = i;
+// The tick's sync point. Staged entities join the array first, then flag changes and destroys are applied in the
+// order they were recorded, so the result only depends on the order entities were updated in.
+void entity_commands_flush(GameState* game_state) {
+    EntityData* entity_data = &game_state->entity_data;
+    EntityCommandBuffer* commands = &entity_data->commands;
+
+    entity_data->entity_count += commands->staged_count;
+    commands->staged_count = 0;
+
+    for (int i = 0; i < commands->count; i++) {
+        EntityCommand* command = &commands->commands[i];
+        Entity* entity = entity_find(command->handle);
+        if (!entity) {
+            continue;
+        }
+
+        switch (command->type) {
+        case ENTITY_COMMAND_SET_FLAGS:
+            set(entity->flags, command->set_flags);
+            unset(entity->flags, command->unset_flags);
+            break;
+        case ENTITY_COMMAND_DESTROY:
+            ASSERT(entity->type != ENTITY_TYPE_PLAYER, "Player entity should never be freed");
+            remove_collision_rules(entity->id, game_state);
+            if (entity->attack_id) {
+                remove_collision_rules(entity->attack_id, game_state);
+            }
+            entity_free(entity->id);
+            break;
+        default:
+            break;
+        }
     }
+
+    commands->count = 0;
+    commands->recording = false;
 }
 
-void player_action_update_from_input(PlayerInputAction* action, KeyInputState key_input_state, float sim_dt_s) {
+void player_action_update_from_input(PlayerInputAction* action, KeyInputState key_input_state, float frame_dt_s) {
     if (key_input_state.is_held) {
-        action->held_duration_s += sim_dt_s;
+        action->held_duration_s += frame_dt_s;
     } else {
         action->held_duration_s = 0;
     }
@@ -223,7 +281,7 @@ void player_action_update_from_input(PlayerInputAction* action, KeyInputState ke
     action->was_released = key_input_state.is_released;
 }
 
-void update_player_input_no_ui(GameInput* game_input, GameState* game_state, float sim_dt_s, PlayerInput* input) {
+void update_player_input_no_ui(GameInput* game_input, GameState* game_state, float frame_dt_s, PlayerInput* input) {
     if (game_input->active_input_type == INPUT_TYPE_KEYBOARD_MOUSE) {
         KeyInputState* key_input_states = game_input->key_input_states;
         Vec2 movement_vec = {};
@@ -259,11 +317,11 @@ void update_player_input_no_ui(GameInput* game_input, GameState* game_state, flo
 #ifdef DEBUG
         if (!is_set(game_state->tools.flags, TOOLS_F_CAPTURING_MOUSE_INPUT)) {
             player_action_update_from_input(&input->world.use_held_item,
-                                            game_input->mouse_state.input_states[MOUSE_LEFT_BUTTON], sim_dt_s);
+                                            game_input->mouse_state.input_states[MOUSE_LEFT_BUTTON], frame_dt_s);
         }
 #else
         player_action_update_from_input(&input->world.use_held_item,
-                                        game_input->mouse_state.input_states[MOUSE_LEFT_BUTTON]);
+                                        game_input->mouse_state.input_states[MOUSE_LEFT_BUTTON], frame_dt_s);
 #endif
 
         Vec2 mouse_world_position = game_state->world_input.mouse_position_world;
@@ -271,8 +329,8 @@ void update_player_input_no_ui(GameInput* game_input, GameState* game_state, flo
         input->world.aim_vec = w_vec_norm(
             {mouse_world_position.x - player_position.x, mouse_world_position.y - (player_position.y + 0.5f)});
 
-        player_action_update_from_input(&input->world.interact, key_input_states[KEY_E], sim_dt_s);
-        player_action_update_from_input(&input->world.open_inventory, key_input_states[KEY_I], sim_dt_s);
+        player_action_update_from_input(&input->world.interact, key_input_states[KEY_E], frame_dt_s);
+        player_action_update_from_input(&input->world.open_inventory, key_input_states[KEY_I], frame_dt_s);
     } else if (game_input->active_input_type == INPUT_TYPE_GAMEPAD) {
         GamepadState* gamepad_state = &game_input->gamepad_state;
         input->world.movement_vec = w_vec_norm(
@@ -280,24 +338,44 @@ void update_player_input_no_ui(GameInput* game_input, GameState* game_state, flo
     }
 }
 
-void update_player_input_ui(GameInput* game_input, PlayerInput* input, float sim_dt_s) {
+void update_player_input_ui(GameInput* game_input, PlayerInput* input, float frame_dt_s) {
     KeyInputState* key_input_states = game_input->key_input_states;
     player_action_update_from_input(&input->ui.select, game_input->mouse_state.input_states[MOUSE_LEFT_BUTTON],
-                                    sim_dt_s);
-    player_action_update_from_input(&input->ui.close, key_input_states[KEY_E], sim_dt_s);
+                                    frame_dt_s);
+    player_action_update_from_input(&input->ui.close, key_input_states[KEY_E], frame_dt_s);
 }
 
-PlayerInput player_input_get(GameInput* game_input, GameState* game_state, float sim_dt_s) {
+PlayerInput player_input_get(GameInput* game_input, GameState* game_state, float frame_dt_s) {
     PlayerInput input = {};
     if (game_state->ui_mode.state == UI_STATE_NONE) {
-        update_player_input_no_ui(game_input, game_state, sim_dt_s, &input);
+        update_player_input_no_ui(game_input, game_state, frame_dt_s, &input);
     } else {
-        update_player_input_ui(game_input, &input, sim_dt_s);
+        update_player_input_ui(game_input, &input, frame_dt_s);
     }
 
     return input;
 }
 
+// The ticks see the latest movement, aim and held state, while presses from frames that ran no tick are kept until one
+// does. Interact and open inventory are handled by the ui once per frame, so only the sim's presses are latched.
+void player_input_latch(PlayerInput* tick_input, PlayerInput* frame_input) {
+    PlayerInput latched = *frame_input;
+
+    PlayerInputAction* use_held_item = &latched.world.use_held_item;
+    use_held_item->was_pressed = use_held_item->was_pressed || tick_input->world.use_held_item.was_pressed;
+    use_held_item->was_released = use_held_item->was_released || tick_input->world.use_held_item.was_released;
+    latched.world.drop_item = latched.world.drop_item || tick_input->world.drop_item;
+
+    *tick_input = latched;
+}
+
+// Called after each tick so the next one in the same frame doesn't see the presses again
+void player_input_consume_presses(PlayerInput* tick_input) {
+    tick_input->world.use_held_item.was_pressed = false;
+    tick_input->world.use_held_item.was_released = false;
+    tick_input->world.drop_item = false;
+}
+
 void debug_render_entity_colliders(Entity* entity, bool has_collided) {
 #ifdef DEBUG
     if (!is_set(entity->flags, ENTITY_F_NONSPACIAL)) {
@@ -318,6 +396,9 @@ void debug_render_entity_colliders(Entity* entity, bool has_collided) {
 
 void entity_command_center_ui_render(Entity* entity, GameState* game_state, RenderGroup* render_group,
                                      GameInput* game_input) {
+    Inventory* inventory = entity_inventory(entity);
+    Inventory* player_inventory = entity_inventory(game_state->player);
+
     Vec2 inventory_ui_size = {13, 16};
     Vec2 ui_position = game_state->camera.position;
     ui_position.x += game_state->camera.size.x / 4;
@@ -354,23 +435,23 @@ void entity_command_center_ui_render(Entity* entity, GameState* game_state, Rend
 
     if (active_tab == UI_COMMAND_CENTER_TAB_INVENTORY) {
         float slot_gap = pixels_to_units(8);
-        Vec2 inventory_dimensions = inventory_get_dimensions_from_capacity(entity->inventory.capacity, 8);
+        Vec2 inventory_dimensions = inventory_get_dimensions_from_capacity(inventory->capacity, 8);
         InventoryInput inventory_input =
-            inventory_render(container, ui_position, &entity->inventory, inventory_dimensions, game_state, game_input,
+            inventory_render(container, ui_position, inventory, inventory_dimensions, game_state, game_input,
                              {.scale = 1, .slot_gap = slot_gap, .background_rgba = COLOR_GRAY});
 
         if (inventory_input.idx_clicked > -1) {
-            InventoryItem slot = entity->inventory.items[inventory_input.idx_clicked];
+            InventoryItem slot = inventory->items[inventory_input.idx_clicked];
             if (slot.entity_type != ENTITY_TYPE_UNKNOWN) {
-                inventory_move_items(inventory_input.idx_clicked, slot.stack_size, &entity->inventory,
-                                     &game_state->player->inventory);
+                inventory_move_items(inventory_input.idx_clicked, slot.stack_size, inventory, player_inventory);
             }
         }
     } else if (active_tab == UI_COMMAND_CENTER_TAB_STRUCTURES) {
         uint32 structure_slot_count = 10;
         Vec2 structure_inventory_dimensions = inventory_get_dimensions_from_capacity(structure_slot_count, 5);
 
-        Inventory structure_inventory = recipes_to_inventory(CRAFTING_RECIPE_BOOK_STRUCTURES, structure_slot_count);
+        Inventory structure_inventory =
+            recipes_to_inventory(CRAFTING_RECIPE_BOOK_STRUCTURES, structure_slot_count, &game_state->frame_arena);
 
         InventoryInput inventory_input = inventory_render(container, ui_position, &structure_inventory,
                                                           structure_inventory_dimensions, game_state, game_input,
@@ -379,12 +460,12 @@ void entity_command_center_ui_render(Entity* entity, GameState* game_state, Rend
                                                            .background_rgba = COLOR_GRAY,
                                                            .recipe_book_type = CRAFTING_RECIPE_BOOK_STRUCTURES,
                                                            .flags = INVENTORY_RENDER_F_FOR_CRAFTING,
-                                                           .crafting_from_inventory = &entity->inventory});
+                                                           .crafting_from_inventory = inventory});
 
         if (inventory_input.idx_clicked >= 0) {
             EntityType selected_entity_type = structure_inventory.items[inventory_input.idx_clicked].entity_type;
             if (selected_entity_type != ENTITY_TYPE_UNKNOWN &&
-                crafting_can_craft_item(CRAFTING_RECIPE_BOOK_STRUCTURES, selected_entity_type, &entity->inventory)) {
+                crafting_can_craft_item(CRAFTING_RECIPE_BOOK_STRUCTURES, selected_entity_type, inventory)) {
                 game_state->ui_mode.placing_structure_type = selected_entity_type;
                 game_state->ui_mode.state = UI_STATE_STRUCTURE_PLACEMENT;
                 game_state->ui_mode.camera_position = entity->position;
@@ -406,6 +487,7 @@ void entity_command_center_placement_ui_update_render(GameState* game_state, Pla
     UIMode* ui_mode = &game_state->ui_mode;
     set(ui_mode->flags, UI_MODE_F_CAMERA_OVERRIDE);
     Entity* command_center = entity_find(ui_mode->entity_handle);
+    Inventory* command_center_inventory = entity_inventory(command_center);
     ui_mode->camera_position = command_center->position;
 
     Vec2 mouse_world_position = game_state->world_input.mouse_position_world;
@@ -420,18 +502,8 @@ void entity_command_center_placement_ui_update_render(GameState* game_state, Pla
                          .w = subject_collider.size.x,
                          .h = subject_collider.size.y};
 
-    for (int i = 0; i < game_state->entity_data.entity_count; i++) {
-        Entity* entity = &game_state->entity_data.entities[i];
-        WorldCollider target_collider = entity_get_world_collider(entity);
-
-        Rect target_rect = {.x = target_collider.position.x,
-                            .y = target_collider.position.y,
-                            .w = target_collider.size.x,
-                            .h = target_collider.size.y};
-
-        if (w_check_aabb_overlap(subject_rect, target_rect)) {
-            valid_placement = false;
-        }
+    if (entity_query_first_overlapping(subject_rect, {}, NULL)) {
+        valid_placement = false;
     }
 
     Vec4 tint = {1, 1, 1, 0.3};
@@ -445,23 +517,29 @@ void entity_command_center_placement_ui_update_render(GameState* game_state, Pla
 
     if (player_input->ui.select.was_pressed && valid_placement &&
         crafting_can_craft_item(CRAFTING_RECIPE_BOOK_STRUCTURES, ui_mode->placing_structure_type,
-                                &command_center->inventory)) {
-        crafting_consume_ingredients(&command_center->inventory, CRAFTING_RECIPE_BOOK_STRUCTURES,
-                                     ui_mode->placing_structure_type);
-        entity_create(ui_mode->placing_structure_type,
-                      {mouse_world_position.x, mouse_world_position.y - (pixels_to_units(structure_sprite.h) / 2)});
+                                command_center_inventory)) {
+        EntityHandle structure_handle =
+            entity_create(ui_mode->placing_structure_type,
+                          {mouse_world_position.x, mouse_world_position.y - (pixels_to_units(structure_sprite.h) / 2)});
+        if (entity_find(structure_handle)) {
+            crafting_consume_ingredients(command_center_inventory, CRAFTING_RECIPE_BOOK_STRUCTURES,
+                                         ui_mode->placing_structure_type);
+        }
     }
 }
 
 void entity_robot_interact_ui_render(Entity* entity, GameState* game_state, RenderGroup* render_group,
                                      GameInput* game_input) {
+    Inventory* inventory = entity_inventory(entity);
+    Inventory* player_inventory = entity_inventory(game_state->player);
+
     float padding = pixels_to_units(16);
     float slot_gap = pixels_to_units(8);
 
     Vec2 inventory_ui_size = {8, 8};
     Vec2 inventory_dimensions = {2, 2};
 
-    ASSERT(inventory_dimensions.x * inventory_dimensions.y == entity->inventory.capacity,
+    ASSERT(inventory_dimensions.x * inventory_dimensions.y == inventory->capacity,
            "entity_robot_interact_ui_render dimensions much match capacity");
 
     Vec2 inventory_ui_position = game_state->camera.position;
@@ -476,28 +554,30 @@ void entity_robot_interact_ui_render(Entity* entity, GameState* game_state, Rend
                                                 .opts = UI_ELEMENT_F_CONTAINER_COL | UI_ELEMENT_F_DRAW_BACKGROUND});
 
     InventoryInput input =
-        inventory_render(container, inventory_ui_position, &entity->inventory, inventory_dimensions, game_state,
+        inventory_render(container, inventory_ui_position, inventory, inventory_dimensions, game_state,
                          game_input, {.scale = 1, .slot_gap = slot_gap, .background_rgba = COLOR_GRAY});
 
     UIElement* start_button = ui_create_button("Start", inventory_ui_position, container);
 
     if (ui_button_pressed(inventory_ui_position, start_button)) {
-        entity->brain.ai_state = AI_STATE_SEARCHING;
+        entity_cold(entity)->brain.ai_state = AI_STATE_SEARCHING;
     }
 
     ui_draw_element(container, inventory_ui_position, render_group);
 
     if (input.idx_clicked > -1) {
-        InventoryItem slot = entity->inventory.items[input.idx_clicked];
+        InventoryItem slot = inventory->items[input.idx_clicked];
         if (slot.entity_type != ENTITY_TYPE_UNKNOWN) {
-            inventory_move_items(input.idx_clicked, slot.stack_size, &entity->inventory,
-                                 &game_state->player->inventory);
+            inventory_move_items(input.idx_clicked, slot.stack_size, inventory, player_inventory);
         }
     }
 }
 
 void entity_robotics_factory_ui_render(Entity* entity, GameState* game_state, RenderGroup* render_group,
                                        GameInput* game_input) {
+    Inventory* inventory = entity_inventory(entity);
+    Inventory* command_center_inventory = entity_inventory(game_state->command_center);
+
     Vec2 inventory_ui_size = {13, 16};
     Vec2 ui_position = game_state->camera.position;
     ui_position.x += game_state->camera.size.x / 4;
@@ -534,22 +614,23 @@ void entity_robotics_factory_ui_render(Entity* entity, GameState* game_state, Re
 
     if (active_tab == UI_ROBOTICS_FACTORY_TAB_INVENTORY) {
         float slot_gap = pixels_to_units(8);
-        Vec2 inventory_dimensions = inventory_get_dimensions_from_capacity(entity->inventory.capacity, 5);
+        Vec2 inventory_dimensions = inventory_get_dimensions_from_capacity(inventory->capacity, 5);
         InventoryInput inventory_input =
-            inventory_render(container, ui_position, &entity->inventory, inventory_dimensions, game_state, game_input,
+            inventory_render(container, ui_position, inventory, inventory_dimensions, game_state, game_input,
                              {.scale = 2, .slot_gap = slot_gap, .background_rgba = COLOR_GRAY});
 
         if (inventory_input.idx_clicked > -1) {
-            InventoryItem* robo_item = &entity->inventory.items[inventory_input.idx_clicked];
+            InventoryItem* robo_item = &inventory->items[inventory_input.idx_clicked];
             Entity* robot = entity_find(robo_item->entity_handle);
             if (robot) {
                 Entity* player = game_state->player;
-                for (int i = 0; i < player->entity_party.capacity; i++) {
-                    if (!entity_find(player->entity_party.handles[i])) {
-                        EntityHandle* handle = &player->entity_party.handles[i];
+                for (int i = 0; i < entity_cold(player)->entity_party.capacity; i++) {
+                    if (!entity_find(entity_cold(player)->entity_party.handles[i])) {
+                        EntityHandle* handle = &entity_cold(player)->entity_party.handles[i];
                         *handle = robo_item->entity_handle;
 
                         inventory_item_clear(robo_item);
+                        inventory_mark_dirty(inventory);
                     }
                 }
             }
@@ -558,7 +639,8 @@ void entity_robotics_factory_ui_render(Entity* entity, GameState* game_state, Re
         uint32 slot_count = 10;
         Vec2 robot_inventory_dimensions = inventory_get_dimensions_from_capacity(slot_count, 5);
 
-        Inventory robot_inventory = recipes_to_inventory(CRAFTING_RECIPE_BOOK_ROBOTS, slot_count);
+        Inventory robot_inventory =
+            recipes_to_inventory(CRAFTING_RECIPE_BOOK_ROBOTS, slot_count, &game_state->frame_arena);
 
         InventoryInput inventory_input = inventory_render(
             container, ui_position, &robot_inventory, robot_inventory_dimensions, game_state, game_input,
@@ -567,15 +649,14 @@ void entity_robotics_factory_ui_render(Entity* entity, GameState* game_state, Re
              .background_rgba = COLOR_GRAY,
              .recipe_book_type = CRAFTING_RECIPE_BOOK_ROBOTS,
              .flags = INVENTORY_RENDER_F_FOR_CRAFTING,
-             .crafting_from_inventory = &game_state->command_center->inventory});
+             .crafting_from_inventory = command_center_inventory});
 
         if (inventory_input.idx_clicked >= 0) {
             EntityType selected_entity_type = robot_inventory.items[inventory_input.idx_clicked].entity_type;
             if (selected_entity_type != ENTITY_TYPE_UNKNOWN &&
-                crafting_can_craft_item(CRAFTING_RECIPE_BOOK_ROBOTS, selected_entity_type,
-                                        &game_state->command_center->inventory)) {
+                crafting_can_craft_item(CRAFTING_RECIPE_BOOK_ROBOTS, selected_entity_type, command_center_inventory)) {
                 crafting_craft_item(selected_entity_type, CRAFTING_RECIPE_BOOK_ROBOTS,
-                                    &game_state->command_center->inventory, &entity->inventory);
+                                    command_center_inventory, inventory);
             }
         }
 
@@ -589,10 +670,13 @@ void entity_robotics_factory_ui_render(Entity* entity, GameState* game_state, Re
 }
 
 void entity_inventory_render(Entity* entity, GameState* game_state, RenderGroup* render_group, GameInput* game_input) {
+    Inventory* inventory = entity_inventory(entity);
+    Inventory* player_inventory = entity_inventory(game_state->player);
+
     float padding = pixels_to_units(16);
     float slot_gap = pixels_to_units(8);
 
-    Vec2 inventory_dimensions = inventory_get_dimensions_from_capacity(entity->inventory.capacity, 4);
+    Vec2 inventory_dimensions = inventory_get_dimensions_from_capacity(inventory->capacity, 4);
     Vec2 inventory_ui_size = inventory_ui_get_size(inventory_dimensions, padding, slot_gap, 1);
 
     Vec2 inventory_ui_position = game_state->camera.position;
@@ -605,21 +689,21 @@ void entity_inventory_render(Entity* entity, GameState* game_state, RenderGroup*
                                                 .opts = UI_ELEMENT_F_CONTAINER_COL | UI_ELEMENT_F_DRAW_BACKGROUND});
 
     InventoryInput input =
-        inventory_render(container, inventory_ui_position, &entity->inventory, inventory_dimensions, game_state,
+        inventory_render(container, inventory_ui_position, inventory, inventory_dimensions, game_state,
                          game_input, {.scale = 1, .slot_gap = slot_gap, .background_rgba = COLOR_GRAY});
 
     ui_draw_element(container, inventory_ui_position, render_group);
 
     if (input.idx_clicked > -1) {
-        InventoryItem slot = entity->inventory.items[input.idx_clicked];
+        InventoryItem slot = inventory->items[input.idx_clicked];
         if (slot.entity_type != ENTITY_TYPE_UNKNOWN) {
-            inventory_move_items(input.idx_clicked, slot.stack_size, &entity->inventory,
-                                 &game_state->player->inventory);
+            inventory_move_items(input.idx_clicked, slot.stack_size, inventory, player_inventory);
         }
     }
 }
 
 void player_inventory_render(GameState* game_state, RenderGroup* render_group, GameInput* game_input) {
+    Inventory* player_inventory = entity_inventory(game_state->player);
     Vec2 crafting_menu_size = {13, 10};
     Vec2 crafting_menu_position = game_state->camera.position;
     crafting_menu_position.x -= (game_state->camera.size.x / 4) + (crafting_menu_size.x / 2);
@@ -638,7 +722,8 @@ void player_inventory_render(GameState* game_state, RenderGroup* render_group, G
     Vec2 inventory_dimensions = {2, 6};
     uint32 inventory_capacity = inventory_dimensions.x * inventory_dimensions.y;
 
-    Inventory inventory = recipes_to_inventory(CRAFTING_RECIPE_BOOK_GENERAL, inventory_capacity);
+    Inventory inventory =
+        recipes_to_inventory(CRAFTING_RECIPE_BOOK_GENERAL, inventory_capacity, &game_state->frame_arena);
 
     InventoryInput inventory_input =
         inventory_render(container, crafting_menu_position, &inventory, inventory_dimensions, game_state, game_input,
@@ -647,7 +732,7 @@ void player_inventory_render(GameState* game_state, RenderGroup* render_group, G
                           .background_rgba = COLOR_GRAY,
                           .recipe_book_type = CRAFTING_RECIPE_BOOK_GENERAL,
                           .flags = INVENTORY_RENDER_F_FOR_CRAFTING,
-                          .crafting_from_inventory = &game_state->player->inventory});
+                          .crafting_from_inventory = player_inventory});
 
     ui_container_size_update(container);
 
@@ -657,9 +742,9 @@ void player_inventory_render(GameState* game_state, RenderGroup* render_group, G
     }
 
     if (inventory_input.idx_clicked > -1) {
-        CraftingRecipe* recipe = crafting_recipe_find(CRAFTING_RECIPE_BOOK_GENERAL, inventory_input.idx_clicked);
+        const CraftingRecipe* recipe = crafting_recipe_find(CRAFTING_RECIPE_BOOK_GENERAL, inventory_input.idx_clicked);
         if (recipe) {
-            crafting_craft_item(recipe->entity_type, CRAFTING_RECIPE_BOOK_GENERAL, &game_state->player->inventory);
+            crafting_craft_item(recipe->entity_type, CRAFTING_RECIPE_BOOK_GENERAL, player_inventory);
         }
     }
 
@@ -703,24 +788,332 @@ Vec2 update_and_get_camera_shake(CameraShake* shake, double dt_s) {
     return shake_offset;
 }
 
-bool debug_entity_is_penetrating_blocker(Entity* entity, EntityData* entity_data) {
+bool debug_entity_is_penetrating_blocker(Entity* entity) {
     WorldCollider subject_collider = entity_get_world_collider(entity);
     Rect subject = {subject_collider.position.x, subject_collider.position.y, subject_collider.size.x,
                     subject_collider.size.y};
 
-    for (int i = 0; i < entity_data->entity_count; i++) {
-        Entity* target = &entity_data->entities[i];
-        if (is_set(target->flags, ENTITY_F_BLOCKER) && target->id != entity->id) {
-            WorldCollider target_collider = entity_get_world_collider(target);
-            Rect target_rect = {target_collider.position.x, target_collider.position.y, target_collider.size.x,
-                                target_collider.size.y};
-            if (w_check_aabb_overlap(subject, target_rect)) {
-                return true;
+    return entity_query_first_overlapping(subject, {.required_flags = ENTITY_F_BLOCKER}, entity) != NULL;
+}
+
+// Cooldowns, hunger and death. Every step runs these, the coarse far sim LOD step included.
+static void entity_step_timers(GameState* game_state, Entity* entity, double dt_s) {
+    EntityCold* cold = entity_cold(entity);
+
+    entity->damage_taken_tint_cooldown_s = w_clamp_min(entity->damage_taken_tint_cooldown_s - dt_s, 0);
+    entity->item_drop_pickup_cooldown_s = w_clamp_min(entity->item_drop_pickup_cooldown_s - dt_s, 0);
+
+    if (is_set(entity->flags, ENTITY_F_GETS_HUNGERY) && !game_state->tools.disable_hunger) {
+        cold->hunger_cooldown_s = w_clamp_min(cold->hunger_cooldown_s - dt_s, 0);
+        if (cold->hunger_cooldown_s <= 0) {
+            cold->hunger = w_clamp_min((int)cold->hunger - 1, 0);
+            cold->hunger_cooldown_s = HUNGER_TICK_COOLDOWN_S;
+        }
+
+        if (cold->hunger <= 0) {
+            entity->hp = 0;
+        }
+    }
+
+    entity_death(entity);
+}
+
+// The step of an entity in a far sim LOD chunk. It doesn't move, think or attack, but its timers run, it still starves
+// and dies, animations finish and projectiles run out of range at the speed they were flying.
+static void entity_coarse_step(GameState* game_state, Entity* entity, double dt_s) {
+    entity_step_timers(game_state, entity, dt_s);
+
+    bool is_animation_complete = w_update_animation(&entity->anim_state, dt_s);
+
+    if (entity->type == ENTITY_TYPE_PROJECTILE) {
+        entity->distance_traveled += w_vec_length(entity->velocity) * dt_s;
+
+        if (entity->distance_traveled > MAX_PROJECTILE_DISTANCE) {
+            entity_mark_for_deletion(entity);
+        }
+    }
+
+    if (is_set(entity->flags, ENTITY_F_DELETE_AFTER_ANIMATION) && is_animation_complete) {
+        entity_mark_for_deletion(entity);
+    }
+}
+
+// One fixed step of g_sim_dt_s: brains, movement and collision, items, hunger and the entity command flush. A frame
+// runs as many ticks as its time covers, possibly none, so nothing in here renders. Entities away from the player
+// step at the rate of their chunk's sim LOD tier.
+static void game_sim_tick(GameState* game_state, PlayerInput* input) {
+    char* tick_marker = w_arena_marker(&game_state->frame_arena);
+
+    entity_save_previous_transforms();
+    entity_snapshot_take();
+    sim_lod_update(&game_state->sim_lod, game_state->player->position, g_sim_dt_s,
+                   game_state->tools.disable_sim_lod);
+
+    game_state->collision_stats = {};
+    CollisionScratch collision_scratch =
+        collision_scratch_alloc(&game_state->frame_arena, game_state->entity_data.store.capacity);
+
+    EntityCold* player_cold = entity_cold(game_state->player);
+    Inventory* player_inventory = entity_inventory(game_state->player);
+
+    entity_commands_begin();
+
+    // ~~~~~~~~~~~~~~ Update entity intentions (brain / player input) ~~~~~~~~~~~~~~~~ //
+
+    brain_update_buckets(game_state, input, g_sim_dt_s);
+    collision_broadphase_gather(game_state, &collision_scratch);
+
+    // TODO: maybe don't do all this logic if item is IN_INVENTORY?
+    for (int i = 0; i < game_state->entity_data.entity_count; i++) {
+        Entity* entity = &game_state->entity_data.entities[i];
+        EntityCold* cold = entity_cold(entity);
+
+        double dt_s = sim_lod_dt_s(&game_state->sim_lod, entity->position);
+        if (dt_s == 0) {
+            double coarse_dt_s = sim_lod_coarse_dt_s(&game_state->sim_lod, entity->position);
+            if (coarse_dt_s > 0) {
+                entity_coarse_step(game_state, entity, coarse_dt_s);
+            }
+            continue;
+        }
+
+        Vec2 starting_position = entity->position;
+
+        collision_move_entity(game_state, entity, dt_s, &collision_scratch);
+
+        entity->z_pos =
+            (0.5f * entity->z_acceleration * w_square(dt_s)) + (entity->z_velocity * dt_s) + entity->z_pos;
+        entity->z_pos = w_clamp_min(entity->z_pos, 0);
+        entity->z_velocity = entity->z_acceleration * dt_s + entity->z_velocity;
+
+        if (is_set(entity->flags, ENTITY_F_ITEM) && !is_set(entity->flags, ENTITY_F_IN_INVENTORY) &&
+            entity->item_drop_pickup_cooldown_s <= 0) {
+            Entity* collector = NULL;
+            entity_query_nearest(entity->position, ITEM_PICKUP_RANGE, {.required_flags = ENTITY_F_COLLECTS_ITEMS}, 1,
+                                 &collector);
+
+            if (collector) {
+                float distance_from_collector = w_euclid_dist(collector->position, entity->position);
+                if (distance_from_collector < 0.1 &&
+                    inventory_space_for_item(entity->type, cold->stack_size, player_inventory)) {
+                    entity->velocity = {};
+                    entity->acceleration = {};
+                    Inventory* target_inventory = entity_inventory(collector);
+                    inventory_add_entity_item(target_inventory, entity);
+                } else if (distance_from_collector < ITEM_PICKUP_RANGE &&
+                           inventory_space_for_item(entity->type, cold->stack_size, player_inventory)) {
+                    Vec2 collector_offset = w_vec_sub(collector->position, entity->position);
+                    Vec2 collector_direction_norm = w_vec_norm(collector_offset);
+                    float current_velocity_mag = w_vec_length(entity->velocity);
+                    if (current_velocity_mag == 0) {
+                        current_velocity_mag = 3;
+                    }
+                    entity->velocity = w_vec_mult(collector_direction_norm, current_velocity_mag);
+                    entity->acceleration = w_vec_mult(collector_direction_norm, 15.0f);
+                    entity_wake(entity);
+                }
+            }
+
+            if (!is_set(entity->flags, ENTITY_F_ITEM_SPAWNING)) {
+                entity->item_floating_anim_timer_s += dt_s;
+                entity->z_pos = w_anim_sine(entity->item_floating_anim_timer_s, 4.0f, 0.10f);
             }
         }
+
+        if (is_set(entity->flags, ENTITY_F_ITEM_SPAWNING) && entity->z_pos == 0) {
+            entity->z_velocity = 0;
+            entity->z_acceleration = 0;
+            entity->velocity = {};
+            entity->acceleration = {};
+            unset(entity->flags, ENTITY_F_ITEM_SPAWNING);
+        }
+
+        entity->z_index = entity->position.y * -1;
+
+        if (entity->type == ENTITY_TYPE_PROJECTILE) {
+            Vec2 position_delta = w_vec_sub(entity->position, starting_position);
+            entity->distance_traveled += w_vec_length(position_delta);
+
+            if (entity->distance_traveled > MAX_PROJECTILE_DISTANCE) {
+                entity_mark_for_deletion(entity);
+            }
+        }
+
+        if (entity->type == ENTITY_TYPE_PLAYER) {
+            InventoryItem* active_hotbar_slot =
+                hotbar_active_slot(player_inventory, game_state->hotbar.active_item_idx);
+
+            if (input->world.drop_item && active_hotbar_slot->stack_size > 0) {
+                float z_index;
+                Vec3 item_position_3d = {};
+                Vec2 item_position = entity_held_item_position(entity, &item_position_3d.z, &z_index);
+                item_position_3d.x = item_position.x;
+                item_position_3d.y = item_position.y;
+
+                entity_inventory_spawn_world_item(active_hotbar_slot, item_position_3d, z_index,
+                                                  entity->facing_direction.x);
+                inventory_mark_dirty(player_inventory);
+            }
+
+            EntityType active_hotbar_entity_type = active_hotbar_slot->entity_type;
+            if (input->world.use_held_item.is_held) {
+                const EntityInfo* e_info = &entity_info[active_hotbar_entity_type];
+                if (is_set(e_info->flags, ENTITY_INFO_F_PLACEABLE) && input->world.use_held_item.was_pressed) {
+                    Vec2 placement_position =
+                        hotbar_placeable_position(game_state->player->position, input->world.aim_vec);
+                    if (entity_find(entity_create(active_hotbar_entity_type, placement_position))) {
+                        inventory_remove_items_by_index(player_inventory, game_state->hotbar.active_item_idx, 1);
+                    }
+                } else if (is_set(e_info->flags, ENTITY_INFO_F_FOOD) && input->world.use_held_item.was_pressed) {
+                    player_cold->hunger = w_clamp_max(player_cold->hunger + e_info->hunger_gain, MAX_HUNGER_PLAYER);
+                    inventory_remove_items_by_index(player_inventory, game_state->hotbar.active_item_idx, 1);
+                }
+            }
+
+            Entity* equipped_entity = entity_find(active_hotbar_slot->entity_handle);
+
+            // TODO: hot bar logic will have to be pulled out if we want this to allow for non-player owners
+            if (equipped_entity) {
+                Vec2 aim_vec_rel_owner = input->world.aim_vec;
+                equipped_entity->z_pos = 0.5f;
+                if (aim_vec_rel_owner.x < 0) {
+                    equipped_entity->position = {entity->position.x - 0.3f, entity->position.y};
+                } else {
+                    equipped_entity->position = {entity->position.x + 0.3f, entity->position.y};
+                }
+
+                if (equipped_entity->type == ENTITY_TYPE_GUN) {
+                    float rotation_rads = atan2(aim_vec_rel_owner.y, aim_vec_rel_owner.x);
+                    equipped_entity->rotation_rads = rotation_rads;
+                    Vec2 pivot = {};
+
+                    if (aim_vec_rel_owner.x < 0) {
+                        pivot = {equipped_entity->position.x + .25f, equipped_entity->position.y};
+                        set(equipped_entity->flags, ENTITY_F_SPRITE_FLIP_X);
+                        // Note: This fixes gun rotation when rads are negative from negative aim vector x
+                        equipped_entity->rotation_rads = M_PI + equipped_entity->rotation_rads;
+                    } else {
+                        pivot = {equipped_entity->position.x - .25f, equipped_entity->position.y};
+                        unset(equipped_entity->flags, ENTITY_F_SPRITE_FLIP_X);
+                    }
+
+                    equipped_entity->position =
+                        w_rotate_around_pivot(equipped_entity->position, pivot, equipped_entity->rotation_rads);
+
+                    if (input->world.use_held_item.was_pressed) {
+                        Vec2 velocity_unit = w_vec_unit_from_radians(rotation_rads);
+                        Vec2 velocity = w_vec_mult(velocity_unit, 30.0f);
+                        Vec2 projectile_position = {equipped_entity->position.x,
+                                                    equipped_entity->position.y + equipped_entity->z_pos};
+                        EntityHandle projectile_handle =
+                            entity_create_projectile(projectile_position, rotation_rads, velocity);
+                        if (entity_find(projectile_handle)) {
+                            add_collision_rule(projectile_handle.id, entity->id, false, game_state);
+                        }
+
+                        play_sound_rand(&game_state->sounds[SOUND_BASIC_GUN_SHOT], &game_state->audio_player);
+                        start_camera_shake(&game_state->camera, 0.1, 10, 0.08);
+                    }
+                }
+
+                // NOTE: after the gun's rotation around its pivot, so the grid cell and bounds match where it is drawn
+                entity_spatial_update(equipped_entity);
+
+                // TODO: maybe the facing_direction should be discrete to begin with?
+                Vec2 owner_facing_direction = entity_discrete_facing_direction_4_directions(entity->facing_direction);
+                if (owner_facing_direction.y > 0) {
+                    equipped_entity->z_index = entity->z_index - 0.1;
+                } else {
+                    equipped_entity->z_index = entity->z_index + 0.1;
+                }
+            }
+        }
+        entity_step_timers(game_state, entity, dt_s);
+
+        bool is_animation_complete = w_update_animation(&entity->anim_state, dt_s);
+
+        Rect subject_hitbox;
+        if (entity_attack_hitbox(entity, &subject_hitbox)) {
+            collision_push_attack_hitbox(&collision_scratch, entity, subject_hitbox);
+        }
+
+        if (is_set(entity->flags, ENTITY_F_DELETE_AFTER_ANIMATION) && is_animation_complete) {
+            entity_mark_for_deletion(entity);
+        }
     }
 
-    return false;
+    collision_resolve_attack_hitboxes(game_state, &collision_scratch);
+
+    proc_gen_update_chunk_states(game_state->player->position, game_state, g_sim_dt_s);
+
+    entity_commands_flush(game_state);
+
+    if (!game_state->tools.disable_entity_reorder) {
+        uint32 player_id = game_state->player->id;
+        uint32 command_center_id = game_state->command_center->id;
+        if (entity_reorder_update()) {
+            game_state->player = entity_from_id(player_id);
+            game_state->command_center = entity_from_id(command_center_id);
+        }
+    }
+
+    w_arena_restore(&game_state->frame_arena, tick_marker);
+}
+
+#define ENTITY_RENDER_BATCH_SIZE 1024
+
+struct EntityRenderJob {
+    EntityData* entity_data;
+    RenderQuad* quads;
+    RenderGroup* batch_groups;
+    float alpha;
+};
+
+// Renders a batch of entities straight into the quads at [start, end) of the main group, an entity emits at most one
+// quad so the batch's range always fits
+static JOB_FUNCTION(entity_render_job) {
+    EntityRenderJob* job = (EntityRenderJob*)data;
+
+    RenderGroup* batch_group = &job->batch_groups[start / ENTITY_RENDER_BATCH_SIZE];
+    batch_group->id = RENDER_GROUP_ID_MAIN;
+    batch_group->size = end - start;
+    batch_group->count = 0;
+    batch_group->quads = &job->quads[start];
+
+    for (uint32 i = start; i < end; i++) {
+        Entity* entity = &job->entity_data->entities[i];
+
+        if (!is_set(entity->flags, ENTITY_F_IN_INVENTORY) && !is_set(entity->flags, ENTITY_F_MARK_FOR_DELETION)) {
+            entity_render(entity, batch_group, job->alpha);
+        }
+    }
+}
+
+// Builds the quads of the world's entities on the job threads. Each batch fills its own slice of the group and the
+// slices are compacted in entity order, so the group ends up the same as if the entities were rendered one by one.
+static void render_entities(GameState* game_state, RenderGroup* render_group, float alpha) {
+    EntityData* entity_data = &game_state->entity_data;
+    uint32 entity_count = entity_data->entity_count;
+    uint32 batch_count = (entity_count + ENTITY_RENDER_BATCH_SIZE - 1) / ENTITY_RENDER_BATCH_SIZE;
+    ASSERT(render_group->count + entity_count <= render_group->size, "Render group reached capacity");
+
+    EntityRenderJob job = {.entity_data = entity_data,
+                           .quads = &render_group->quads[render_group->count],
+                           .alpha = alpha};
+    job.batch_groups = (RenderGroup*)w_arena_alloc(&game_state->frame_arena, batch_count * sizeof(RenderGroup));
+
+    JobCounter counter = {};
+    g_jobs->parallel_for(entity_render_job, &job, entity_count, ENTITY_RENDER_BATCH_SIZE, &counter);
+    g_jobs->wait(&counter);
+
+    // NOTE: a batch's slice never starts before the compacted end, so moving them front to back doesn't overwrite
+    // quads that weren't moved yet
+    for (int i = 0; i < batch_count; i++) {
+        RenderGroup* batch_group = &job.batch_groups[i];
+        memmove(&render_group->quads[render_group->count], batch_group->quads,
+                batch_group->count * sizeof(RenderQuad));
+        render_group->count += batch_group->count;
+    }
 }
 
 extern "C" GAME_UPDATE_AND_RENDER(game_update_and_render) {
@@ -729,9 +1122,13 @@ extern "C" GAME_UPDATE_AND_RENDER(game_update_and_render) {
     g_base_path = game_memory->base_path;
 #ifdef DEBUG
     g_debug_info = &game_memory->debug_info;
+    debug_game_memory = game_memory;
 #endif
 
-    g_sim_dt_s = frame_dt_s;
+    g_sim_dt_s = 1.0 / game_memory->sim_tick_rate_hz;
+    g_jobs = &game_memory->jobs;
+    g_get_performance_counter = game_memory->get_performance_counter;
+    g_performance_frequency = game_memory->performance_frequency;
 
     game_state->viewport_scale_factor = get_viewport_scale_factor(game_memory->window.size_px);
     g_pixels_per_unit = BASE_PIXELS_PER_UNIT * game_state->viewport_scale_factor;
@@ -742,10 +1139,13 @@ extern "C" GAME_UPDATE_AND_RENDER(game_update_and_render) {
 
     game_state->world_input.mouse_position_world =
         get_mouse_world_position(&game_state->camera, game_input, game_memory->window.size_px);
-    w_init_waffle_lib(g_base_path);
-    w_init_animation(animation_table);
-    entity_init(&game_state->entity_data);
-    crafting_init();
+    // NOTE: the tables are static data, only the pointers into them have to be restored after a hot reload
+    if (!g_game_code_loaded) {
+        g_game_code_loaded = true;
+        w_init_waffle_lib(g_base_path);
+        w_init_animation(animation_table);
+        entity_init(&game_state->entity_data);
+    }
 
     if (!is_set(game_state->flags, GAME_STATE_F_INITIALIZED)) {
         set(game_state->flags, GAME_STATE_F_INITIALIZED);
@@ -754,10 +1154,6 @@ extern "C" GAME_UPDATE_AND_RENDER(game_update_and_render) {
         game_state->main_arena.data = (char*)game_memory->memory + sizeof(GameState);
         game_state->main_arena.next = game_state->main_arena.data;
 
-        game_state->frame_arena.size = Megabytes(10);
-        game_state->frame_arena.data = w_arena_alloc(&game_state->main_arena, game_state->frame_arena.size);
-        game_state->frame_arena.next = game_state->frame_arena.data;
-
         game_state->camera.position = {0, 0};
         game_state->camera.size = {BASE_RESOLUTION_WIDTH / BASE_PIXELS_PER_UNIT,
                                    BASE_RESOLUTION_HEIGHT / BASE_PIXELS_PER_UNIT};
@@ -828,8 +1224,11 @@ extern "C" GAME_UPDATE_AND_RENDER(game_update_and_render) {
             w_arena_restore(&game_state->main_arena, main_marker);
         }
 
-        init_entity_data(&game_state->entity_data);
+        init_entity_data(game_state, game_memory->reserve_memory, game_memory->commit_memory);
+
+#ifdef DEBUG
         tools_init(&game_state->tools);
+#endif
         Entity* command_center = NULL;
 
         {
@@ -849,6 +1248,8 @@ extern "C" GAME_UPDATE_AND_RENDER(game_update_and_render) {
         ASSERT(game_state->command_center, "command center must exist at initialization");
 
         game_state->world_seed = 12756671;
+        game_state->attack_id_next = ATTACK_ID_START;
+        game_state->brain_scheduler.think_budget = BRAIN_THINK_BUDGET;
 
         proc_gen_init_chunk_states({DEFAULT_WORLD_WIDTH, DEFAULT_WORLD_HEIGHT}, &game_state->chunk_spawn,
                                    game_state->world_seed);
@@ -863,8 +1264,8 @@ extern "C" GAME_UPDATE_AND_RENDER(game_update_and_render) {
         proc_gen_plants(&game_state->decoration_data, &game_state->world_gen_context.plant_fbm_context);
 
         if (command_center) {
-            inventory_add_item(&command_center->inventory, ENTITY_TYPE_IRON, 99);
-            inventory_add_item(&command_center->inventory, ENTITY_TYPE_COAL, 99);
+            inventory_add_item(entity_inventory(command_center), ENTITY_TYPE_IRON, 99);
+            inventory_add_item(entity_inventory(command_center), ENTITY_TYPE_COAL, 99);
         }
     }
 
@@ -901,7 +1302,7 @@ extern "C" GAME_UPDATE_AND_RENDER(game_update_and_render) {
     render_group_decorations.size = MAX_DECORATIONS;
     render_group_decorations.quads =
         (RenderQuad*)w_arena_alloc(&game_state->frame_arena, render_group_decorations.size * sizeof(RenderQuad));
-    main_render_group.size = MAX_ENTITIES * 2;
+    main_render_group.size = game_state->entity_data.store.capacity * 2;
     main_render_group.quads =
         (RenderQuad*)w_arena_alloc(&game_state->frame_arena, main_render_group.size * sizeof(RenderQuad));
     render_group_ui.size = 250;
@@ -912,15 +1313,15 @@ extern "C" GAME_UPDATE_AND_RENDER(game_update_and_render) {
     render_group_tools.size = MAX_WORLD_ENTITY_INITS + 1000;
     render_group_tools.quads =
         (RenderQuad*)w_arena_alloc(&game_state->frame_arena, render_group_tools.size * sizeof(RenderQuad));
-    debug_render_group.size = MAX_ENTITIES * 2;
+    debug_render_group.size = game_state->entity_data.store.capacity * 2;
     debug_render_group.quads =
         (RenderQuad*)w_arena_alloc(&game_state->frame_arena, debug_render_group.size * sizeof(RenderQuad));
     g_debug_render_group = &debug_render_group;
 
     tools_update_and_render(game_memory, game_state, game_input, &render_group_tools);
 #endif
-
-    Entity* closest_interactable_entity = entity_closest_player_interactable(game_state->player);
+    // NOTE: after the tools panel, which lists what changed since the last clear
+    entity_dirty_clear();
 
     // ~~~~~~~~~~~~~~~~~~ Render decorations ~~~~~~~~~~~~~~~~~~~~~~ //
     {
@@ -942,338 +1343,78 @@ extern "C" GAME_UPDATE_AND_RENDER(game_update_and_render) {
         }
     }
 
-    PlayerInput player_input = player_input_get(game_input, game_state, g_sim_dt_s);
-
-    // TODO: maybe don't do all this logic if item is IN_INVENTORY?
-    for (int i = 0; i < game_state->entity_data.entity_count; i++) {
-        Entity* entity = &game_state->entity_data.entities[i];
-
-        // ~~~~~~~~~~~~~~ Update entity intentions (brain / player input) ~~~~~~~~~~~~~~~~ //
+    PlayerInput player_input = player_input_get(game_input, game_state, frame_dt_s);
+    player_input_latch(&game_state->tick_input, &player_input);
 
-        brain_update(entity, game_state, &player_input, g_sim_dt_s);
+    game_state->sim_accumulator_s += frame_dt_s;
+    game_state->sim_ticks_this_frame = 0;
+    while (game_state->sim_accumulator_s >= g_sim_dt_s) {
+        StartTimedBlock(SimTick);
+        game_sim_tick(game_state, &game_state->tick_input);
+        EndTimedBlock(SimTick);
 
-        Vec2 starting_position = entity->position;
-
-        // bool has_collided = false;
-        // Note: This is an optimization
-        if (!is_set(entity->flags, ENTITY_F_NONSPACIAL)) {
-            double t_remaining = 1.0f;
-            for (int attempts = 0; attempts < 4 && t_remaining > 0.0f; attempts++) {
-                double t_min = 1.0f;
-                Vec2 collision_normal = {0, 0};
-                Entity* entity_collided_with = NULL;
-
-                WorldCollider subject_collider = entity_get_world_collider(entity);
-                Vec2 subject_delta = w_calc_position_delta(entity->acceleration, entity->velocity,
-                                                           subject_collider.position, t_remaining * g_sim_dt_s);
-
-                for (int j = 0; j < game_state->entity_data.entity_count; j++) {
-                    Entity* target_entity = &game_state->entity_data.entities[j];
-
-                    if (should_collide(entity, target_entity, game_state->collision_rule_hash)) {
-                        Rect subject = {subject_collider.position.x, subject_collider.position.y,
-                                        subject_collider.size.x, subject_collider.size.y};
-
-                        WorldCollider target_collider = entity_get_world_collider(target_entity);
-                        Vec2 target_delta = w_calc_position_delta(target_entity->acceleration, target_entity->velocity,
-                                                                  target_collider.position, g_sim_dt_s);
-
-                        Rect target = {target_collider.position.x, target_collider.position.y, target_collider.size.x,
-                                       target_collider.size.y};
-
-                        double prev_t_min = t_min;
-
-                        w_rect_collision(subject, subject_delta, target, target_delta, &t_min, &collision_normal);
-
-                        if (t_min != prev_t_min) {
-                            entity_collided_with = target_entity;
-                        }
-                    }
-                }
+        player_input_consume_presses(&game_state->tick_input);
+        game_state->sim_accumulator_s -= g_sim_dt_s;
+        game_state->sim_ticks_this_frame++;
+    }
 
-                if (t_min < 1) {
-                    t_min = w_max(0.0, t_min - 0.8); // epsilon adjustment
-                }
+    // NOTE: entities are drawn between the last two ticks, so what's on screen is up to a tick behind the simulation
+    float sim_alpha = (float)(game_state->sim_accumulator_s / g_sim_dt_s);
 
-                double t_effective = t_min * t_remaining;
-                t_remaining -= t_effective;
-                double effective_dt_s = t_effective * g_sim_dt_s;
+    // ~~~~~~~~~~~~~~~~~~ Render entities ~~~~~~~~~~~~~~~~~~~~~~ //
+    render_entities(game_state, &main_render_group, sim_alpha);
 
-                bool can_move_freely = true;
-                if (entity_collided_with) {
-                    handle_collision(entity, entity_collided_with, collision_normal, effective_dt_s, &can_move_freely,
-                                     game_state);
-                    // has_collided = true
-                }
+    {
+        InventoryItem* active_hotbar_slot =
+            hotbar_active_slot(entity_inventory(game_state->player), game_state->hotbar.active_item_idx);
 
-                if (can_move_freely) {
-                    entity->position =
-                        w_calc_position(entity->acceleration, entity->velocity, entity->position, effective_dt_s);
-                    entity->velocity = w_calc_velocity(entity->acceleration, entity->velocity, effective_dt_s);
-                }
-            }
+        Entity* equipped_entity = entity_find(active_hotbar_slot->entity_handle);
+        if (equipped_entity) {
+            entity_render(equipped_entity, &main_render_group, sim_alpha);
         } else {
-            entity->position = w_calc_position(entity->acceleration, entity->velocity, entity->position, g_sim_dt_s);
-            entity->velocity = w_calc_velocity(entity->acceleration, entity->velocity, g_sim_dt_s);
+            hotbar_render_item(game_state, player_input.world.aim_vec, &main_render_group, sim_alpha);
         }
+    }
 
-        entity->z_pos =
-            (0.5f * entity->z_acceleration * w_square(g_sim_dt_s)) + (entity->z_velocity * g_sim_dt_s) + entity->z_pos;
-        entity->z_pos = w_clamp_min(entity->z_pos, 0);
-        entity->z_velocity = entity->z_acceleration * g_sim_dt_s + entity->z_velocity;
-
-        if (is_set(entity->flags, ENTITY_F_ITEM) && !is_set(entity->flags, ENTITY_F_IN_INVENTORY) &&
-            entity->item_drop_pickup_cooldown_s <= 0) {
-            Entity* collector = NULL;
-            float distance_from_collector = ITEM_PICKUP_RANGE;
-
-            for (int i = 0; i < game_state->entity_data.entity_count; i++) {
-                Entity* possible_collector = &game_state->entity_data.entities[i];
-
-                if (is_set(possible_collector->flags, ENTITY_F_COLLECTS_ITEMS)) {
-                    float distance = w_euclid_dist(possible_collector->position, entity->position);
-
-                    if (distance <= distance_from_collector) {
-                        distance_from_collector = distance;
-                        collector = possible_collector;
-                    }
-                }
-            }
-
-            if (collector) {
-                if (distance_from_collector < 0.1 &&
-                    inventory_space_for_item(entity->type, entity->stack_size, &game_state->player->inventory)) {
-                    entity->velocity = {};
-                    entity->acceleration = {};
-                    Inventory* target_inventory = &collector->inventory;
-                    inventory_add_entity_item(target_inventory, entity);
-                } else if (distance_from_collector < ITEM_PICKUP_RANGE &&
-                           inventory_space_for_item(entity->type, entity->stack_size, &game_state->player->inventory)) {
-                    Vec2 collector_offset = w_vec_sub(collector->position, entity->position);
-                    Vec2 collector_direction_norm = w_vec_norm(collector_offset);
-                    float current_velocity_mag = w_vec_length(entity->velocity);
-                    if (current_velocity_mag == 0) {
-                        current_velocity_mag = 3;
-                    }
-                    entity->velocity = w_vec_mult(collector_direction_norm, current_velocity_mag);
-                    entity->acceleration = w_vec_mult(collector_direction_norm, 15.0f);
-                }
-            }
-
-            if (!is_set(entity->flags, ENTITY_F_ITEM_SPAWNING)) {
-                entity->item_floating_anim_timer_s += g_sim_dt_s;
-                entity->z_pos = w_anim_sine(entity->item_floating_anim_timer_s, 4.0f, 0.10f);
-            }
-        }
-
-        if (is_set(entity->flags, ENTITY_F_ITEM_SPAWNING) && entity->z_pos == 0) {
-            entity->z_velocity = 0;
-            entity->z_acceleration = 0;
-            entity->velocity = {};
-            entity->acceleration = {};
-            unset(entity->flags, ENTITY_F_ITEM_SPAWNING);
-        }
-
-        entity->z_index = entity->position.y * -1;
-
-        if (entity->type == ENTITY_TYPE_PROJECTILE) {
-            Vec2 position_delta = w_vec_sub(entity->position, starting_position);
-            entity->distance_traveled += w_vec_length(position_delta);
-
-            if (entity->distance_traveled > MAX_PROJECTILE_DISTANCE) {
-                set(entity->flags, ENTITY_F_MARK_FOR_DELETION);
-            }
-        }
-
-        if (entity->type == ENTITY_TYPE_PLAYER) {
-            InventoryItem* active_hotbar_slot =
-                hotbar_active_slot(&game_state->player->inventory, game_state->hotbar.active_item_idx);
-
-            if (player_input.world.drop_item && active_hotbar_slot->stack_size > 0) {
-                float z_index;
-                Vec3 item_position_3d = {};
-                Vec2 item_position = entity_held_item_position(entity, &item_position_3d.z, &z_index);
-                item_position_3d.x = item_position.x;
-                item_position_3d.y = item_position.y;
-
-                entity_inventory_spawn_world_item(active_hotbar_slot, item_position_3d, z_index,
-                                                  entity->facing_direction.x);
-            }
-
-            EntityType active_hotbar_entity_type = active_hotbar_slot->entity_type;
-            if (player_input.world.use_held_item.is_held) {
-                EntityInfo* e_info = &entity_info[active_hotbar_entity_type];
-                if (is_set(e_info->flags, ENTITY_INFO_F_PLACEABLE) && player_input.world.use_held_item.was_pressed) {
-                    Vec2 placement_position =
-                        hotbar_placeable_position(game_state->player->position, player_input.world.aim_vec);
-                    entity_create(active_hotbar_entity_type, placement_position);
-                    inventory_remove_items_by_index(&game_state->player->inventory, game_state->hotbar.active_item_idx,
-                                                    1);
-                } else if (is_set(e_info->flags, ENTITY_INFO_F_FOOD) && player_input.world.use_held_item.was_pressed) {
-                    game_state->player->hunger =
-                        w_clamp_max(game_state->player->hunger + e_info->hunger_gain, MAX_HUNGER_PLAYER);
-                    inventory_remove_items_by_index(&game_state->player->inventory, game_state->hotbar.active_item_idx,
-                                                    1);
-                }
-            }
-
-            Entity* equipped_entity = entity_find(active_hotbar_slot->entity_handle);
-
-            // TODO: hot bar logic will have to be pulled out if we want this to allow for non-player owners
-            if (equipped_entity) {
-                Vec2 aim_vec_rel_owner = player_input.world.aim_vec;
-                equipped_entity->z_pos = 0.5f;
-                if (aim_vec_rel_owner.x < 0) {
-                    equipped_entity->position = {entity->position.x - 0.3f, entity->position.y};
-                } else {
-                    equipped_entity->position = {entity->position.x + 0.3f, entity->position.y};
-                }
-
-                if (equipped_entity->type == ENTITY_TYPE_GUN) {
-                    float rotation_rads = atan2(aim_vec_rel_owner.y, aim_vec_rel_owner.x);
-                    equipped_entity->rotation_rads = rotation_rads;
-                    Vec2 pivot = {};
-
-                    if (aim_vec_rel_owner.x < 0) {
-                        pivot = {equipped_entity->position.x + .25f, equipped_entity->position.y};
-                        set(equipped_entity->flags, ENTITY_F_SPRITE_FLIP_X);
-                        // Note: This fixes gun rotation when rads are negative from negative aim vector x
-                        equipped_entity->rotation_rads = M_PI + equipped_entity->rotation_rads;
-                    } else {
-                        pivot = {equipped_entity->position.x - .25f, equipped_entity->position.y};
-                        unset(equipped_entity->flags, ENTITY_F_SPRITE_FLIP_X);
-                    }
-
-                    equipped_entity->position =
-                        w_rotate_around_pivot(equipped_entity->position, pivot, equipped_entity->rotation_rads);
-
-                    if (player_input.world.use_held_item.was_pressed) {
-                        Vec2 velocity_unit = w_vec_unit_from_radians(rotation_rads);
-                        Vec2 velocity = w_vec_mult(velocity_unit, 30.0f);
-                        Vec2 projectile_position = {equipped_entity->position.x,
-                                                    equipped_entity->position.y + equipped_entity->z_pos};
-                        EntityHandle projectile_handle =
-                            entity_create_projectile(projectile_position, rotation_rads, velocity);
-                        add_collision_rule(projectile_handle.id, entity->id, false, game_state);
-
-                        play_sound_rand(&game_state->sounds[SOUND_BASIC_GUN_SHOT], &game_state->audio_player);
-                        start_camera_shake(&game_state->camera, 0.1, 10, 0.08);
-                    }
-                }
-
-                // TODO: maybe the facing_direction should be discrete to begin with?
-                Vec2 owner_facing_direction = entity_discrete_facing_direction_4_directions(entity->facing_direction);
-                if (owner_facing_direction.y > 0) {
-                    equipped_entity->z_index = entity->z_index - 0.1;
-                } else {
-                    equipped_entity->z_index = entity->z_index + 0.1;
-                }
-            }
-        }
-        entity->damage_taken_tint_cooldown_s = w_clamp_min(entity->damage_taken_tint_cooldown_s - g_sim_dt_s, 0);
-        entity->item_drop_pickup_cooldown_s = w_clamp_min(entity->item_drop_pickup_cooldown_s - g_sim_dt_s, 0);
-
-        if (is_set(entity->flags, ENTITY_F_GETS_HUNGERY) && !game_state->tools.disable_hunger) {
-            entity->hunger_cooldown_s = w_clamp_min(entity->hunger_cooldown_s - g_sim_dt_s, 0);
-            if (entity->hunger_cooldown_s <= 0) {
-                entity->hunger = w_clamp_min((int)entity->hunger - 1, 0);
-                entity->hunger_cooldown_s = HUNGER_TICK_COOLDOWN_S;
-            }
-
-            if (entity->hunger <= 0) {
-                entity->hp = 0;
-            }
-        }
-
-        entity_death(entity);
-
-        bool is_animation_complete = w_update_animation(&entity->anim_state, g_sim_dt_s);
-
-        SpriteID sprite_id = w_animation_current_sprite(&entity->anim_state);
-
-        Rect anim_hitbox = hitbox_table[sprite_id];
-
-        // TODO: Maybe collapse this into the collision loop above?
-        if (w_rect_has_area(anim_hitbox)) {
-            anim_hitbox = w_rect_mult(anim_hitbox, 1.0 / BASE_PIXELS_PER_UNIT);
-
-            anim_hitbox.x = entity->position.x + anim_hitbox.x;
-            anim_hitbox.y = entity->position.y + anim_hitbox.y;
-
-            Rect subject_hitbox = {
-                anim_hitbox.x,
-                anim_hitbox.y,
-                anim_hitbox.w,
-                anim_hitbox.h,
-            };
+    // NOTE: the debug group isn't safe to push to from the jobs, so the debug draws get their own pass
+    Tools* tools = &game_state->tools;
+    if (tools->draw_hitboxes || tools->draw_entity_positions || tools->draw_colliders) {
+        for (int i = 0; i < game_state->entity_data.entity_count; i++) {
+            Entity* entity = &game_state->entity_data.entities[i];
 
-            if (game_state->tools.draw_hitboxes) {
+            Rect subject_hitbox;
+            if (game_state->tools.draw_hitboxes && entity_attack_hitbox(entity, &subject_hitbox)) {
                 debug_render_rect((Vec2){subject_hitbox.x, subject_hitbox.y},
                                   (Vec2){subject_hitbox.w, subject_hitbox.h}, {255, 0, 0, 0.5});
             }
 
-            for (int j = 0; j < game_state->entity_data.entity_count; j++) {
-                Entity* target_entity = &game_state->entity_data.entities[j];
-                if (entity->id != target_entity->id && !is_set(entity->flags, ENTITY_F_NONSPACIAL) &&
-                    !is_set(target_entity->flags, ENTITY_F_NONSPACIAL) &&
-                    is_set(target_entity->flags, ENTITY_F_KILLABLE)) {
-
-                    CollisionRule* collision_rule =
-                        find_collision_rule(entity->attack_id, target_entity->id, game_state);
-                    if (!collision_rule || collision_rule->should_collide) {
-                        WorldCollider target_collider = entity_get_world_collider(target_entity);
-
-                        Rect target = {target_collider.position.x, target_collider.position.y, target_collider.size.x,
-                                       target_collider.size.y};
-
-                        if (w_check_aabb_overlap(subject_hitbox, target)) {
-                            entity_deal_damage(target_entity, 1, game_state);
-                            add_collision_rule(entity->attack_id, target_entity->id, false, game_state);
-                        }
-                    }
-                }
-            }
-        }
-
-        if (is_set(entity->flags, ENTITY_F_DELETE_AFTER_ANIMATION) && is_animation_complete) {
-            set(entity->flags, ENTITY_F_MARK_FOR_DELETION);
-        }
-
-        bool should_render = true;
-        if (is_set(entity->flags, ENTITY_F_IN_INVENTORY)) {
-            should_render = false;
-        } else if (is_set(entity->flags, ENTITY_F_MARK_FOR_DELETION)) {
-            should_render = false;
-        }
-
-        if (should_render) {
-            if (!is_set(entity->flags, ENTITY_F_MARK_FOR_DELETION)) {
-                entity_render(entity, &main_render_group);
+            if (is_set(entity->flags, ENTITY_F_IN_INVENTORY) || is_set(entity->flags, ENTITY_F_MARK_FOR_DELETION)) {
+                continue;
             }
 
             if (game_state->tools.draw_entity_positions) {
-                debug_render_rect(entity->position, pixels_to_units({1, 1}), {0, 255, 0, 1});
+                debug_render_rect(entity_interpolated_position(entity, sim_alpha), pixels_to_units({1, 1}),
+                                  {0, 255, 0, 1});
             }
 
             if (game_state->tools.draw_colliders) {
                 debug_render_entity_colliders(entity, false);
             }
         }
+    }
 
-        if (entity->type == ENTITY_TYPE_PLAYER) {
-            InventoryItem* active_hotbar_slot =
-                hotbar_active_slot(&game_state->player->inventory, game_state->hotbar.active_item_idx);
+    if (tools->draw_sim_lod) {
+        // NOTE: near is green, mid yellow and far red
+        Vec4 tier_colors[SIM_LOD_TIER_COUNT] = {{0, 255, 0, 0.15}, {255, 255, 0, 0.15}, {255, 0, 0, 0.15}};
 
-            Entity* equipped_entity = entity_find(active_hotbar_slot->entity_handle);
-            if (equipped_entity) {
-                entity_render(equipped_entity, &main_render_group);
-            } else {
-                hotbar_render_item(game_state, player_input.world.aim_vec, &main_render_group);
-            }
+        for (int i = 0; i < SIM_LOD_CHUNK_COUNT; i++) {
+            Rect bounds = sim_lod_chunk_bounds(i);
+            SimLodTier tier = game_state->sim_lod.chunks[i].tier;
+            debug_render_rect({bounds.x, bounds.y}, {bounds.w, bounds.h}, tier_colors[tier]);
         }
     }
 
-    proc_gen_update_chunk_states(game_state->player->position, game_state, g_sim_dt_s);
+    Entity* closest_interactable_entity = entity_closest_player_interactable(game_state->player);
 
     unset(game_state->ui_mode.flags, UI_MODE_F_INVENTORY_ACTIVE);
     unset(game_state->ui_mode.flags, UI_MODE_F_CAMERA_OVERRIDE);
@@ -1298,7 +1439,7 @@ extern "C" GAME_UPDATE_AND_RENDER(game_update_and_render) {
 
     if (game_state->ui_mode.state == UI_STATE_ENTITY_UI) {
         Entity* ui_entity = entity_find(game_state->ui_mode.entity_handle);
-        if (ui_entity->inventory.capacity > 0) {
+        if (entity_inventory(ui_entity)->capacity > 0) {
             set(game_state->ui_mode.flags, UI_MODE_F_INVENTORY_ACTIVE);
         }
         if (ui_entity->type == ENTITY_TYPE_ROBOT_GATHERER) {
@@ -1317,21 +1458,10 @@ extern "C" GAME_UPDATE_AND_RENDER(game_update_and_render) {
     }
 
 #ifdef DEBUG
-    hotbar_validate(&game_state->player->inventory);
+    hotbar_validate(entity_inventory(game_state->player));
 #endif
 
-    for (int i = 0; i < game_state->entity_data.entity_count; i++) {
-        Entity* entity = &game_state->entity_data.entities[i];
-        if (is_set(entity->flags, ENTITY_F_MARK_FOR_DELETION)) {
-            ASSERT(entity->type != ENTITY_TYPE_PLAYER, "Player entity should never be freed");
-            remove_collision_rules(entity->id, game_state->collision_rule_hash, &game_state->collision_rule_free_list);
-            entity_free(entity->id);
-            // Ensures we process the element that was inserted to replace the freed entity
-            i--;
-        }
-    }
-
-    Vec2 camera_target_position = game_state->player->position;
+    Vec2 camera_target_position = entity_interpolated_position(game_state->player, sim_alpha);
     float camera_target_zoom = 1.0f;
 
     if (is_set(game_state->ui_mode.flags, UI_MODE_F_CAMERA_OVERRIDE)) {
@@ -1346,13 +1476,13 @@ extern "C" GAME_UPDATE_AND_RENDER(game_update_and_render) {
     float smoothing_factor = 8;
     Vec2 camera_to_target_offset = w_vec_sub(camera_target_position, game_state->camera.position);
     Vec2 camera_delta = w_vec_mult(camera_to_target_offset, smoothing_factor);
-    camera_delta = w_vec_mult(camera_delta, g_sim_dt_s);
+    camera_delta = w_vec_mult(camera_delta, frame_dt_s);
     game_state->camera.position = w_vec_add(game_state->camera.position, camera_delta);
 
     float camera_zoom_offset = camera_target_zoom - game_state->camera.zoom;
-    game_state->camera.zoom += camera_zoom_offset * smoothing_factor * g_sim_dt_s;
+    game_state->camera.zoom += camera_zoom_offset * smoothing_factor * frame_dt_s;
 
-    Vec2 shake_offset = update_and_get_camera_shake(&game_state->camera.shake, g_sim_dt_s);
+    Vec2 shake_offset = update_and_get_camera_shake(&game_state->camera.shake, frame_dt_s);
     Vec2 rendered_camera_position = w_vec_add(game_state->camera.position, shake_offset);
 
     sort_render_group(&main_render_group);
@@ -27,16 +27,19 @@ InventoryItem* hotbar_active_slot(Inventory* inventory, uint32 active_item_idx)
     return &inventory->items[active_item_idx];
 }
 
-void hotbar_render_item(GameState* game_state, Vec2 player_aim_vec, RenderGroup* render_group) {
+void hotbar_render_item(GameState* game_state, Vec2 player_aim_vec, RenderGroup* render_group, float alpha) {
     Entity* player = game_state->player;
     HotBar* hotbar = &game_state->hotbar;
 
-    InventoryItem* slot = &player->inventory.items[hotbar->active_item_idx];
+    InventoryItem* slot = &entity_inventory(player)->items[hotbar->active_item_idx];
 
     Entity* slot_entity = entity_find(slot->entity_handle);
     if (!slot_entity && slot->stack_size > 0) {
         float z_pos, z_index;
         Vec2 item_position = entity_held_item_position(player, &z_pos, &z_index);
+        // NOTE: follows the player as it is drawn, the placement indicator stays where placing would happen
+        item_position = w_vec_add(item_position,
+                                  w_vec_sub(entity_interpolated_position(player, alpha), player->position));
 
         SpriteID sprite_id = entity_info[slot->entity_type].default_sprite;
         item_position.y += z_pos;
@@ -51,7 +54,7 @@ void hotbar_render_item(GameState* game_state, Vec2 player_aim_vec, RenderGroup*
 
 void hotbar_render(GameState* game_state, GameInput* game_input, RenderGroup* render_group) {
     float padding = 0.5f;
-    Inventory* player_inventory = &game_state->player->inventory;
+    Inventory* player_inventory = entity_inventory(game_state->player);
 
     UIElement* container =
         ui_create_container({.padding = padding, .opts = UI_ELEMENT_F_CONTAINER_ROW | UI_ELEMENT_F_DRAW_BACKGROUND});
@@ -85,7 +88,7 @@ void hotbar_render(GameState* game_state, GameInput* game_input, RenderGroup* re
 
         if (item->entity_type != ENTITY_TYPE_UNKNOWN) {
             inventory_move_items(inventory_input.idx_clicked, item->stack_size, player_inventory,
-                                 &entity_with_open_inventory->inventory);
+                                 entity_inventory(entity_with_open_inventory));
         }
     }
 
@@ -13,7 +13,7 @@ static SpriteID player_hp_to_ui_sprite[MAX_HP_PLAYER + 1] = {
 
 static void render_player_health_ui(Entity* player, Camera camera, RenderGroup* render_group) {
     SpriteID hp_sprite_id = player_hp_to_ui_sprite[player->hp];
-    SpriteID hunger_sprite_id = player_hunger_to_ui_sprite[player->hunger];
+    SpriteID hunger_sprite_id = player_hunger_to_ui_sprite[entity_cold(player)->hunger];
     Sprite hp_sprite = sprite_table[hp_sprite_id];
     Sprite hunger_sprite = sprite_table[hunger_sprite_id];
 
@@ -33,7 +33,7 @@ static void render_player_health_ui(Entity* player, Camera camera, RenderGroup*
 
 static void render_player_party_ui(Entity* player, GameState* game_state, GameInput* game_input,
                                    RenderGroup* render_group) {
-    Vec2 dimensions = {(float)player->entity_party.capacity, 1};
+    Vec2 dimensions = {(float)entity_cold(player)->entity_party.capacity, 1};
     float padding = pixels_to_units(8);
     float slot_gap = pixels_to_units(8);
     float scale = 2.0f;
@@ -48,10 +48,9 @@ static void render_player_party_ui(Entity* player, GameState* game_state, GameIn
                                                 .max_size = ui_size,
                                                 .opts = UI_ELEMENT_F_CONTAINER_COL});
 
-    Inventory inventory = {};
-    inventory.capacity = player->entity_party.capacity;
+    Inventory inventory = inventory_alloc(&game_state->frame_arena, entity_cold(player)->entity_party.capacity);
     for (int i = 0; i < inventory.capacity; i++) {
-        Entity* entity = entity_find(player->entity_party.handles[i]);
+        Entity* entity = entity_find(entity_cold(player)->entity_party.handles[i]);
         if (entity) {
             inventory.items[i].entity_type = entity->type;
             inventory.items[i].stack_size = 1;
@@ -76,11 +75,13 @@ static void render_player_party_ui(Entity* player, GameState* game_state, GameIn
 
     if (robotics_factory_inventory_ui_open && input.idx_clicked > -1) {
         EntityType robot_type = inventory.items[input.idx_clicked].entity_type;
+        Inventory* factory_inventory = entity_inventory(ui_entity);
 
-        if (robot_type != ENTITY_TYPE_UNKNOWN && inventory_space_for_item(robot_type, 1, &ui_entity->inventory)) {
-            Entity* party_entity = entity_find(player->entity_party.handles[input.idx_clicked]);
-            inventory_add_entity_item(&ui_entity->inventory, party_entity);
-            player->entity_party.handles[input.idx_clicked] = entity_null_handle;
+        if (robot_type != ENTITY_TYPE_UNKNOWN && inventory_space_for_item(robot_type, 1, factory_inventory)) {
+            EntityParty* party = &entity_cold(player)->entity_party;
+            Entity* party_entity = entity_find(party->handles[input.idx_clicked]);
+            inventory_add_entity_item(factory_inventory, party_entity);
+            party->handles[input.idx_clicked] = entity_null_handle;
         }
     }
 
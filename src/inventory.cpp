@@ -3,12 +3,6 @@
 
 #define INVENTORY_BASE_SLOT_DIMENSION 1
 
-void inventory_init(Inventory* inventory, uint32 item_count) {
-    for (int i = 0; i < item_count; i++) {
-        inventory->items[i].entity_handle.generation = -1;
-    }
-}
-
 bool inventory_should_persist_entity(EntityType entity_type) {
     return is_set(entity_info[entity_type].flags, ENTITY_INFO_F_PERSIST_IN_INVENTORY);
 }
@@ -19,6 +13,26 @@ void inventory_item_clear(InventoryItem* item) {
     item->entity_type = ENTITY_TYPE_UNKNOWN;
 }
 
+// Returns an empty inventory with its slots in the arena, for inventories that are only built to be rendered
+Inventory inventory_alloc(Arena* arena, uint32 capacity) {
+    Inventory inventory = {.owner_id = INVENTORY_NO_OWNER};
+    inventory.items = (InventoryItem*)w_arena_alloc(arena, capacity * sizeof(InventoryItem));
+    inventory.capacity = capacity;
+
+    for (int i = 0; i < capacity; i++) {
+        inventory_item_clear(&inventory.items[i]);
+    }
+
+    return inventory;
+}
+
+// Inventories in the pool belong to an entity, which is marked ENTITY_DIRTY_INVENTORY whenever a slot changes
+void inventory_mark_dirty(Inventory* inventory) {
+    if (inventory->owner_id != INVENTORY_NO_OWNER) {
+        entity_mark_dirty_id(inventory->owner_id, ENTITY_DIRTY_INVENTORY);
+    }
+}
+
 void inventory_remove_items_by_index(Inventory* inventory, uint32 index, uint32 quantity) {
     InventoryItem* item = &inventory->items[index];
 
@@ -29,6 +43,8 @@ void inventory_remove_items_by_index(Inventory* inventory, uint32 index, uint32
     if (item->stack_size <= 0) {
         inventory_item_clear(item);
     }
+
+    inventory_mark_dirty(inventory);
 }
 
 void inventory_remove_items(Inventory* inventory, EntityType entity_type, uint32 quantity) {
@@ -84,6 +100,7 @@ void inventory_add_item(Inventory* inventory, EntityType entity_type, uint32 qua
 
     open_slot->entity_type = entity_type;
     open_slot->stack_size += quantity;
+    inventory_mark_dirty(inventory);
 }
 
 // TODO: this should probably take an EntityHandle
@@ -94,18 +111,20 @@ void inventory_add_entity_item(Inventory* inventory, Entity* item) {
         if (inventory_should_persist_entity(item->type)) {
             open_slot->entity_handle = entity_to_handle(item);
         } else {
-            set(item->flags, ENTITY_F_MARK_FOR_DELETION);
+            entity_mark_for_deletion(item);
         }
 
         open_slot->entity_type = item->type;
-        open_slot->stack_size += item->stack_size;
+        open_slot->stack_size += entity_cold(item)->stack_size;
         set(item->flags, ENTITY_F_IN_INVENTORY);
+        entity_mark_dirty(item, ENTITY_DIRTY_LIFECYCLE);
+        inventory_mark_dirty(inventory);
     }
 }
 
 bool inventory_contains_item(Inventory* inventory, EntityType entity_type, uint32 quantity) {
     uint32 quantity_found = 0;
-    for (int i = 0; i < HOTBAR_MAX_SLOTS; i++) {
+    for (int i = 0; i < inventory->capacity; i++) {
         if (inventory->items[i].entity_type == entity_type) {
             quantity_found += inventory->items[i].stack_size;
         }
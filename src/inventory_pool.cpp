@@ -0,0 +1,101 @@
+#include "game.h"
+
+static uint32 inventory_pool_class_slots(uint32 size_class) {
+    return INVENTORY_POOL_MIN_CLASS_SLOTS << size_class;
+}
+
+static uint32 inventory_pool_size_class(uint32 capacity) {
+    ASSERT(capacity <= INVENTORY_MAX_CAPACITY, "inventory capacity is larger than the largest size class");
+
+    uint32 size_class = 0;
+    while (inventory_pool_class_slots(size_class) < capacity) {
+        size_class++;
+    }
+
+    return size_class;
+}
+
+// Returns NULL when the class has no free block and INVENTORY_POOL_MAX_ITEMS has no room for another
+static InventoryItem* inventory_pool_alloc_block(InventoryPool* pool, uint32 size_class) {
+    uint32 slots = inventory_pool_class_slots(size_class);
+    uint32 offset = pool->free_blocks[size_class];
+
+    if (offset != INVENTORY_POOL_NULL) {
+        pool->free_blocks[size_class] = pool->items[offset].stack_size;
+    } else {
+        if (pool->items_used + slots > INVENTORY_POOL_MAX_ITEMS) {
+            return NULL;
+        }
+
+        offset = pool->items_used;
+        pool->items_used += slots;
+    }
+
+    InventoryItem* block = &pool->items[offset];
+    for (int i = 0; i < slots; i++) {
+        block[i] = {.entity_type = ENTITY_TYPE_UNKNOWN, .entity_handle = {.generation = -1}, .stack_size = 0};
+    }
+
+    return block;
+}
+
+static void inventory_pool_free_block(InventoryPool* pool, InventoryItem* block, uint32 size_class) {
+    uint32 offset = block - pool->items;
+
+    block->stack_size = pool->free_blocks[size_class];
+    pool->free_blocks[size_class] = offset;
+}
+
+void inventory_pool_clear(InventoryPool* pool) {
+    pool->inventories[0] = {.owner_id = INVENTORY_NO_OWNER};
+    pool->inventory_count = 1;
+    pool->free_id_count = 0;
+    pool->items_used = 0;
+
+    for (int i = 0; i < INVENTORY_POOL_SIZE_CLASS_COUNT; i++) {
+        pool->free_blocks[i] = INVENTORY_POOL_NULL;
+    }
+}
+
+// Returns the id of a new inventory with empty slots. When the pool is out of inventories or item slots it returns 0,
+// the empty inventory, so the entity spawns without storage.
+uint32 inventory_pool_alloc(InventoryPool* pool, uint32 capacity, uint32 owner_id) {
+    ASSERT(capacity > 0, "inventories in the pool must have a capacity");
+
+    if (pool->free_id_count == 0 && pool->inventory_count >= INVENTORY_POOL_MAX_INVENTORIES) {
+        return 0;
+    }
+
+    uint32 size_class = inventory_pool_size_class(capacity);
+    InventoryItem* items = inventory_pool_alloc_block(pool, size_class);
+    if (!items) {
+        return 0;
+    }
+
+    uint32 id;
+    if (pool->free_id_count > 0) {
+        id = pool->free_ids[--pool->free_id_count];
+    } else {
+        id = pool->inventory_count++;
+    }
+
+    Inventory* inventory = &pool->inventories[id];
+    inventory->size_class = size_class;
+    inventory->items = items;
+    inventory->capacity = capacity;
+    inventory->owner_id = owner_id;
+
+    return id;
+}
+
+void inventory_pool_free(InventoryPool* pool, uint32 id) {
+    if (id == 0) {
+        return;
+    }
+
+    Inventory* inventory = &pool->inventories[id];
+    inventory_pool_free_block(pool, inventory->items, inventory->size_class);
+    *inventory = {.owner_id = INVENTORY_NO_OWNER};
+
+    pool->free_ids[pool->free_id_count++] = id;
+}
@@ -0,0 +1,349 @@
+// Work stealing job system behind GameMemory::jobs. Every thread owns a queue of batches, it pushes and pops the
+// newest batch at the tail while idle threads steal the oldest one from the head. The main thread is worker 0, it
+// runs batches whenever it kicks or waits on work. Idle threads sleep on a condition variable until there is work.
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+
+typedef CRITICAL_SECTION JobLock;
+typedef CONDITION_VARIABLE JobCondition;
+typedef HANDLE JobThread;
+#define JOB_THREAD_LOCAL __declspec(thread)
+#else
+#include <pthread.h>
+
+typedef pthread_mutex_t JobLock;
+typedef pthread_cond_t JobCondition;
+typedef pthread_t JobThread;
+#define JOB_THREAD_LOCAL __thread
+#endif
+
+#define JOB_QUEUE_SIZE 4096
+
+struct Job {
+    JobFunction* function;
+    void* data;
+    uint32 start;
+    uint32 end;
+    JobCounter* counter;
+};
+
+// NOTE: head and tail only ever grow, the slot of a job is its position modulo JOB_QUEUE_SIZE
+struct JobQueue {
+    JobLock lock;
+    uint32 head;
+    uint32 tail;
+    Job jobs[JOB_QUEUE_SIZE];
+};
+
+struct JobSystem {
+    uint32 thread_count;
+    bool running;
+    int32 queued_count;
+    JobLock sleep_lock;
+    JobCondition wake;
+    JobThread threads[JOB_MAX_THREADS];
+    JobQueue queues[JOB_MAX_THREADS];
+    Arena arenas[JOB_MAX_THREADS];
+};
+
+static JobSystem job_system;
+static JOB_THREAD_LOCAL uint32 job_thread_index;
+
+// ~~~~~~~~~~~~~~~~~~ Threading Primitives ~~~~~~~~~~~~~~~~~~ //
+
+#ifdef _WIN32
+static void job_lock_init(JobLock* lock) {
+    InitializeCriticalSection(lock);
+}
+
+static void job_lock_destroy(JobLock* lock) {
+    DeleteCriticalSection(lock);
+}
+
+static void job_lock(JobLock* lock) {
+    EnterCriticalSection(lock);
+}
+
+static void job_unlock(JobLock* lock) {
+    LeaveCriticalSection(lock);
+}
+
+static void job_condition_init(JobCondition* condition) {
+    InitializeConditionVariable(condition);
+}
+
+static void job_condition_destroy(JobCondition* condition) {
+}
+
+static void job_condition_wait(JobCondition* condition, JobLock* lock) {
+    SleepConditionVariableCS(condition, lock, INFINITE);
+}
+
+static void job_condition_wake_all(JobCondition* condition) {
+    WakeAllConditionVariable(condition);
+}
+#else
+static void job_lock_init(JobLock* lock) {
+    pthread_mutex_init(lock, NULL);
+}
+
+static void job_lock_destroy(JobLock* lock) {
+    pthread_mutex_destroy(lock);
+}
+
+static void job_lock(JobLock* lock) {
+    pthread_mutex_lock(lock);
+}
+
+static void job_unlock(JobLock* lock) {
+    pthread_mutex_unlock(lock);
+}
+
+static void job_condition_init(JobCondition* condition) {
+    pthread_cond_init(condition, NULL);
+}
+
+static void job_condition_destroy(JobCondition* condition) {
+    pthread_cond_destroy(condition);
+}
+
+static void job_condition_wait(JobCondition* condition, JobLock* lock) {
+    pthread_cond_wait(condition, lock);
+}
+
+static void job_condition_wake_all(JobCondition* condition) {
+    pthread_cond_broadcast(condition);
+}
+#endif
+
+// ~~~~~~~~~~~~~~~~~~~~~~ Job Queues ~~~~~~~~~~~~~~~~~~~~~~ //
+
+static void job_queue_push(JobQueue* queue, Job job) {
+    ASSERT(queue->tail - queue->head < JOB_QUEUE_SIZE, "JOB_QUEUE_SIZE has been reached!");
+    queue->jobs[queue->tail++ % JOB_QUEUE_SIZE] = job;
+}
+
+static bool job_queue_pop(JobQueue* queue, Job* job) {
+    bool found = false;
+
+    job_lock(&queue->lock);
+    if (queue->tail != queue->head) {
+        *job = queue->jobs[--queue->tail % JOB_QUEUE_SIZE];
+        found = true;
+    }
+    job_unlock(&queue->lock);
+
+    return found;
+}
+
+static bool job_queue_steal(JobQueue* queue, Job* job) {
+    bool found = false;
+
+    job_lock(&queue->lock);
+    if (queue->tail != queue->head) {
+        *job = queue->jobs[queue->head++ % JOB_QUEUE_SIZE];
+        found = true;
+    }
+    job_unlock(&queue->lock);
+
+    return found;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~ Job System ~~~~~~~~~~~~~~~~~~~~~~ //
+
+static void job_system_wake_all() {
+    job_lock(&job_system.sleep_lock);
+    job_condition_wake_all(&job_system.wake);
+    job_unlock(&job_system.sleep_lock);
+}
+
+// Splits count into batches on the thread's own queue and wakes the sleeping threads
+static void job_system_push_batches(uint32 thread_index, JobFunction* function, void* data, uint32 count,
+                                    uint32 batch_size, JobCounter* counter) {
+    uint32 batch_count = (count + batch_size - 1) / batch_size;
+
+    // NOTE: pushed last batch first so the kicking thread pops them in order and thieves take from the far end
+    JobQueue* queue = &job_system.queues[thread_index];
+    job_lock(&queue->lock);
+    for (int batch = batch_count - 1; batch >= 0; batch--) {
+        uint32 start = batch * batch_size;
+        job_queue_push(queue, {.function = function,
+                               .data = data,
+                               .start = start,
+                               .end = (uint32)w_min(start + batch_size, count),
+                               .counter = counter});
+    }
+    job_unlock(&queue->lock);
+
+    w_atomic_add_i32(&job_system.queued_count, batch_count);
+
+    job_system_wake_all();
+}
+
+// Runs one job from the thread's own queue or stolen from another, returns false when there was nothing to run
+static bool job_system_run_next(uint32 thread_index) {
+    Job job;
+    bool found = job_queue_pop(&job_system.queues[thread_index], &job);
+    for (int i = 1; !found && i < job_system.thread_count; i++) {
+        found = job_queue_steal(&job_system.queues[(thread_index + i) % job_system.thread_count], &job);
+    }
+
+    if (!found) {
+        return false;
+    }
+
+    w_atomic_add_i32(&job_system.queued_count, -1);
+
+    JobContext context = {.thread_index = thread_index, .arena = &job_system.arenas[thread_index]};
+    job.function(job.data, job.start, job.end, &context);
+
+    // NOTE: whoever finishes a counter's last batch wakes the threads waiting on it
+    if (w_atomic_add_i32(&job.counter->pending, -1) == 1) {
+        job_system_wake_all();
+    }
+
+    return true;
+}
+
+static void job_worker_loop(uint32 thread_index) {
+    job_thread_index = thread_index;
+
+    while (true) {
+        if (job_system_run_next(thread_index)) {
+            continue;
+        }
+
+        job_lock(&job_system.sleep_lock);
+        while (job_system.running && w_atomic_load_i32(&job_system.queued_count) == 0) {
+            job_condition_wait(&job_system.wake, &job_system.sleep_lock);
+        }
+        bool running = job_system.running;
+        job_unlock(&job_system.sleep_lock);
+
+        if (!running) {
+            break;
+        }
+    }
+}
+
+#ifdef _WIN32
+static DWORD WINAPI job_worker_main(LPVOID param) {
+    job_worker_loop((uint32)(uintptr_t)param);
+    return 0;
+}
+
+static void job_thread_start(JobThread* thread, uint32 thread_index) {
+    *thread = CreateThread(NULL, 0, job_worker_main, (LPVOID)(uintptr_t)thread_index, 0, NULL);
+    ASSERT(*thread, "failed to start a job worker thread");
+}
+
+static void job_thread_join(JobThread thread) {
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+#else
+static void* job_worker_main(void* param) {
+    job_worker_loop((uint32)(uintptr_t)param);
+    return NULL;
+}
+
+static void job_thread_start(JobThread* thread, uint32 thread_index) {
+    int result = pthread_create(thread, NULL, job_worker_main, (void*)(uintptr_t)thread_index);
+    ASSERT(result == 0, "failed to start a job worker thread");
+}
+
+static void job_thread_join(JobThread thread) {
+    pthread_join(thread, NULL);
+}
+#endif
+
+JOB_PARALLEL_FOR(job_parallel_for) {
+    ASSERT(batch_size > 0, "parallel for needs a batch size");
+
+    uint32 batch_count = (count + batch_size - 1) / batch_size;
+    if (batch_count == 0) {
+        return;
+    }
+
+    w_atomic_add_i32(&counter->pending, batch_count);
+    job_system_push_batches(job_thread_index, function, data, count, batch_size, counter);
+}
+
+JOB_WAIT(job_wait) {
+    while (w_atomic_load_i32(&counter->pending) > 0) {
+        if (job_system_run_next(job_thread_index)) {
+            continue;
+        }
+
+        // NOTE: the rest of the batches are running on other threads, sleep until one of them finishes a
+        // counter or queues more work
+        job_lock(&job_system.sleep_lock);
+        while (w_atomic_load_i32(&counter->pending) > 0 && w_atomic_load_i32(&job_system.queued_count) == 0) {
+            job_condition_wait(&job_system.wake, &job_system.sleep_lock);
+        }
+        job_unlock(&job_system.sleep_lock);
+    }
+}
+
+// Starts thread_count - 1 workers, the calling thread is worker 0
+void job_system_init(Jobs* jobs, uint32 thread_count) {
+    thread_count = (uint32)w_clamp_between(thread_count, 1, JOB_MAX_THREADS);
+
+    job_system.thread_count = thread_count;
+    job_system.running = true;
+    job_system.queued_count = 0;
+    job_thread_index = 0;
+    job_lock_init(&job_system.sleep_lock);
+    job_condition_init(&job_system.wake);
+
+    for (int i = 0; i < thread_count; i++) {
+        JobQueue* queue = &job_system.queues[i];
+        job_lock_init(&queue->lock);
+        queue->head = 0;
+        queue->tail = 0;
+
+        Arena* arena = &job_system.arenas[i];
+        arena->size = JOB_THREAD_ARENA_SIZE;
+        arena->data = (char*)malloc(arena->size);
+        arena->next = arena->data;
+        ASSERT(arena->data, "failed to allocate a job thread arena");
+    }
+
+    for (int i = 1; i < thread_count; i++) {
+        job_thread_start(&job_system.threads[i], i);
+    }
+
+    jobs->parallel_for = job_parallel_for;
+    jobs->wait = job_wait;
+    jobs->thread_count = thread_count;
+}
+
+// Stops and joins the workers, nothing may be queued
+void job_system_shutdown() {
+    job_lock(&job_system.sleep_lock);
+    job_system.running = false;
+    job_condition_wake_all(&job_system.wake);
+    job_unlock(&job_system.sleep_lock);
+
+    for (int i = 1; i < job_system.thread_count; i++) {
+        job_thread_join(job_system.threads[i]);
+    }
+
+    for (int i = 0; i < job_system.thread_count; i++) {
+        job_lock_destroy(&job_system.queues[i].lock);
+        free(job_system.arenas[i].data);
+        job_system.arenas[i] = {};
+    }
+
+    job_lock_destroy(&job_system.sleep_lock);
+    job_condition_destroy(&job_system.wake);
+}
+
+// Resets every thread's arena, called between frames while no jobs are running
+void job_system_begin_frame() {
+    for (int i = 0; i < job_system.thread_count; i++) {
+        job_system.arenas[i].next = job_system.arenas[i].data;
+    }
+}
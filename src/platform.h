@@ -8,7 +8,15 @@
 #include "imgui.h"
 #endif
 
-enum ProfileTimerID { ProfileTimerID_GameStateInitialization, ProfileTimerIDCount };
+enum ProfileTimerID {
+    ProfileTimerID_GameStateInitialization,
+    ProfileTimerID_BrainPlayer,
+    ProfileTimerID_BrainSchedule,
+    ProfileTimerID_BrainJobs,
+    ProfileTimerID_BrainIntents,
+    ProfileTimerID_SimTick,
+    ProfileTimerIDCount
+};
 
 struct ProfileTimer {
     uint64 ticks_elapsed;
@@ -32,14 +40,60 @@ struct ProfileTimer {
 #define GET_PERFORMANCE_COUNTER(name) uint64 name()
 typedef GET_PERFORMANCE_COUNTER(GetPerformanceCounter);
 
+// Reserves address space without backing it, commit_memory backs [address, address + size) with zeroed pages
+#define RESERVE_MEMORY(name) void* name(uint64 size)
+typedef RESERVE_MEMORY(ReserveMemory);
+
+#define COMMIT_MEMORY(name) bool name(void* address, uint64 size)
+typedef COMMIT_MEMORY(CommitMemory);
+
 #define START_TEXT_INPUT(name) bool name()
 typedef START_TEXT_INPUT(StartTextInput);
 
 #define STOP_TEXT_INPUT(name) bool name()
 typedef STOP_TEXT_INPUT(StopTextInput);
 
+// The platform runs a worker per core and the game splits work into batches of a parallel for. The thread that
+// kicks a parallel for or waits on a counter runs jobs too, so the main thread is always worker 0.
+#define JOB_MAX_THREADS 16
+#define JOB_THREAD_ARENA_SIZE Megabytes(32)
+
+// arena is owned by the running thread and reset by the platform at the start of every frame
+struct JobContext {
+    uint32 thread_index;
+    Arena* arena;
+};
+
+#define JOB_FUNCTION(name) void name(void* data, uint32 start, uint32 end, JobContext* context)
+typedef JOB_FUNCTION(JobFunction);
+
+// Number of batches still to run, kicking adds to it and each finished batch subtracts one
+struct JobCounter {
+    int32 pending;
+};
+
+// Runs function over [0, count) in batches of batch_size, counter reaches 0 once all of them are done
+#define JOB_PARALLEL_FOR(name)                                                                                         \
+    void name(JobFunction* function, void* data, uint32 count, uint32 batch_size, JobCounter* counter)
+typedef JOB_PARALLEL_FOR(JobParallelFor);
+
+// Runs queued jobs until counter reaches 0
+#define JOB_WAIT(name) void name(JobCounter* counter)
+typedef JOB_WAIT(JobWait);
+
+struct Jobs {
+    JobParallelFor* parallel_for;
+    JobWait* wait;
+    uint32 thread_count;
+};
+
 #define FRAME_TIME_HISTORY_MAX_COUNT 120
 
+// The game simulates in fixed ticks of 1 / sim_tick_rate_hz seconds and runs as many of them as the frame time covers.
+// Frames are clamped to SIM_MAX_TICKS_PER_FRAME ticks so a long stall slows the game down instead of snowballing.
+#define SIM_TICK_RATE_HZ 60
+#define SIM_MAX_TICKS_PER_FRAME 4
+
 struct DebugInfo {
     double rendered_dt_history[FRAME_TIME_HISTORY_MAX_COUNT];
     uint32 rendered_dt_history_count;
@@ -57,6 +111,7 @@ struct GameMemory {
     void* memory;
     long long size;
     uint64 performance_frequency;
+    uint32 sim_tick_rate_hz;
     Window window;
     char base_path[W_PATH_MAX];
 
@@ -68,12 +123,17 @@ struct GameMemory {
     InitAudio* init_audio;
     PushAudioSamples* push_audio_samples;
     GetPerformanceCounter* get_performance_counter;
+    ReserveMemory* reserve_memory;
+    CommitMemory* commit_memory;
     StartTextInput* start_text_input;
     StopTextInput* stop_text_input;
+    Jobs jobs;
 
     // Debug
 
+#ifdef DEBUG
     ImGuiContext* imgui_context;
+#endif
     DebugInfo debug_info;
 };
 
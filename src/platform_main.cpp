@@ -19,6 +19,9 @@
 
 #ifdef _WIN32
 #define stat _stat
+#include <windows.h>
+#else
+#include <sys/mman.h>
 #endif
 
 #include <glad/glad.h>
@@ -27,6 +30,7 @@
 #include "audio.h"
 #include "sdl_audio.cpp"
 #include "opengl_renderer.cpp"
+#include "job_system.cpp"
 
 #ifdef DEBUG
 
@@ -40,7 +44,7 @@ static char base_path[W_PATH_MAX];
 
 #define MAX_FRAME_RATE 120.0f
 #define MIN_FRAME_TIME_S 1 / MAX_FRAME_RATE
-#define MAX_FRAME_TIME_S 1 / 30.f
+#define MAX_FRAME_TIME_S (SIM_MAX_TICKS_PER_FRAME / (double)SIM_TICK_RATE_HZ)
 
 #define MIN_SCREEN_WIDTH 640
 #define MIN_SCREEN_HEIGHT 360
@@ -95,6 +99,23 @@ GET_PERFORMANCE_COUNTER(get_performance_counter) {
     return SDL_GetPerformanceCounter();
 }
 
+RESERVE_MEMORY(reserve_memory) {
+#ifdef _WIN32
+    return VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+    void* result = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return result == MAP_FAILED ? NULL : result;
+#endif
+}
+
+COMMIT_MEMORY(commit_memory) {
+#ifdef _WIN32
+    return VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+#else
+    return mprotect(address, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
 START_TEXT_INPUT(start_text_input) {
     return SDL_StartTextInput(window);
 }
@@ -375,11 +396,15 @@ int main(int argc, char* argv[]) {
     game_memory.load_texture = load_texture;
     game_memory.push_render_group = push_render_group;
     game_memory.get_performance_counter = get_performance_counter;
+    game_memory.reserve_memory = reserve_memory;
+    game_memory.commit_memory = commit_memory;
     game_memory.start_text_input = start_text_input;
     game_memory.stop_text_input = stop_text_input;
     game_memory.init_audio = init_audio;
     game_memory.push_audio_samples = push_audio_samples;
     game_memory.performance_frequency = SDL_GetPerformanceFrequency();
+    game_memory.sim_tick_rate_hz = SIM_TICK_RATE_HZ;
+    job_system_init(&game_memory.jobs, SDL_GetNumLogicalCPUCores());
     game_memory.window.size = {MIN_SCREEN_WIDTH * 2.1, MIN_SCREEN_HEIGHT * 2.1};
     w_str_copy(game_memory.base_path, (char*)SDL_GetBasePath());
 
@@ -457,7 +482,7 @@ int main(int argc, char* argv[]) {
             game = load_game_code();
         }
 #ifdef DEBUG
-        // memset(game_memory.debug_info.profile_timers, 0, sizeof(game_memory.debug_info.profile_timers));
+        memset(game_memory.debug_info.profile_timers, 0, sizeof(game_memory.debug_info.profile_timers));
 #endif
 
         clear_inputs(&game_input);
@@ -518,6 +543,7 @@ int main(int argc, char* argv[]) {
         // ImGui::ShowDemoWindow();
 #endif
 
+        job_system_begin_frame();
         game.game_update_and_render(&game_memory, &game_input, frame_dt_s);
 
         DebugInfo* debug_info = &game_memory.debug_info;
@@ -555,6 +581,8 @@ int main(int argc, char* argv[]) {
     ImGui::DestroyContext();
 #endif
 
+    job_system_shutdown();
+
     SDL_GL_DestroyContext(gl_context);
     SDL_DestroyWindow(window);
     SDL_Quit();
@@ -148,6 +148,11 @@ void proc_gen_spawn_resources_for_chunk(ChunkSpawnState* state, GameState* game_
                     float max_radius =
                         w_rng_range_f32(&state->rng, spawn_entry.min_patch_radius, spawn_entry.max_patch_radius);
 
+                    ASSERT(node_count <= MAX_SPAWN_BATCH, "resource patch has more nodes than MAX_SPAWN_BATCH");
+
+                    Vec2 node_positions[MAX_SPAWN_BATCH];
+                    uint32 node_position_count = 0;
+
                     for (int i = 0; i < node_count; i++) {
                         float angle = w_rng_f32(&state->rng) * 2 * W_PI;
                         float radius = w_rng_f32(&state->rng) * max_radius;
@@ -157,9 +162,11 @@ void proc_gen_spawn_resources_for_chunk(ChunkSpawnState* state, GameState* game_
                         Vec2 item_position = w_vec_add(patch_position, offset);
 
                         if (w_check_point_in_rect(chunk_bounds, item_position)) {
-                            entity_create(spawn_entry.entity_type, item_position);
+                            node_positions[node_position_count++] = item_position;
                         }
                     }
+
+                    entity_spawn_batch(spawn_entry.entity_type, node_positions, node_position_count);
                 }
             }
         }
@@ -221,6 +228,11 @@ void proc_gen_update_chunk_states(Vec2 player_position, GameState* game_state, d
 
                     uint32 count = w_rng_range_i32(&state->rng, spawn_entry.group_min, spawn_entry.group_max);
 
+                    ASSERT(count <= MAX_SPAWN_BATCH, "spawn group is larger than MAX_SPAWN_BATCH");
+
+                    Vec2 spawn_positions[MAX_SPAWN_BATCH];
+                    uint32 spawn_position_count = 0;
+
                     for (int i = 0; i < count; i++) {
                         Vec2 spawn_position;
 
@@ -228,11 +240,13 @@ void proc_gen_update_chunk_states(Vec2 player_position, GameState* game_state, d
                             state, &spawn_position, game_state->player->position, chunk_coord);
 
                         if (spawn_position_found) {
-                            entity_create(spawn_entry.entity_type, spawn_position);
+                            spawn_positions[spawn_position_count++] = spawn_position;
                         }
                     }
 
-                    state->current_population += count;
+                    if (entity_spawn_batch(spawn_entry.entity_type, spawn_positions, spawn_position_count)) {
+                        state->current_population += count;
+                    }
                 }
             }
         }
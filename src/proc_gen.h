@@ -6,6 +6,7 @@
 #define MAX_CHUNK_SPAWN_STATES 64
 #define PLAYER_SAFE_DIMENSION 48
 #define MAX_SPAWN_GROUP_MEMBERS 8
+#define MAX_SPAWN_BATCH 32 // largest group or resource patch spawned with one entity_spawn_batch
 
 #define CHUNK_SPAWN_STATE_F_RESOURCES_SPAWNED (1 << 0)
 
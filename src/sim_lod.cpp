@@ -0,0 +1,106 @@
+// Simulation level of detail. Every spawn chunk gets a tier from its distance to the player, entities then step by
+// the dt of the chunk they stand in: brains, the broadphase gather and the entity loop all skip an entity whose chunk
+// has nothing to step this tick. Far chunks don't move or think, the entity loop only keeps their timers and
+// lifecycle going at a low rate.
+#include "game.h"
+
+static int sim_lod_chunk_coord(float top_left_coord) {
+    int coord = (int)w_floorf(top_left_coord / SPAWN_CHUNK_DIMENSION);
+
+    if (coord < 0) {
+        coord = 0;
+    } else if (coord >= SIM_LOD_CHUNKS_WIDE) {
+        coord = SIM_LOD_CHUNKS_WIDE - 1;
+    }
+
+    return coord;
+}
+
+// Same rows and columns as the spawn chunks, rows count down from the top of the world
+static uint32 sim_lod_chunk_index(Vec2 position) {
+    int col = sim_lod_chunk_coord(position.x + (DEFAULT_WORLD_WIDTH / 2.0f));
+    int row = sim_lod_chunk_coord((DEFAULT_WORLD_HEIGHT / 2.0f) - position.y);
+
+    return row * SIM_LOD_CHUNKS_WIDE + col;
+}
+
+// Picks the tier of every chunk by its distance in chunks to focus_position and what the chunk steps this tick. With
+// disabled set every chunk is near. Called once at the start of every sim tick.
+void sim_lod_update(SimLod* lod, Vec2 focus_position, double sim_dt_s, bool disabled) {
+    uint32 focus_idx = sim_lod_chunk_index(focus_position);
+    int focus_row = focus_idx / SIM_LOD_CHUNKS_WIDE;
+    int focus_col = focus_idx % SIM_LOD_CHUNKS_WIDE;
+
+    memset(lod->tier_counts, 0, sizeof(lod->tier_counts));
+
+    for (int row = 0; row < SIM_LOD_CHUNKS_WIDE; row++) {
+        for (int col = 0; col < SIM_LOD_CHUNKS_WIDE; col++) {
+            uint32 idx = row * SIM_LOD_CHUNKS_WIDE + col;
+            SimLodChunk* chunk = &lod->chunks[idx];
+
+            int distance = (int)w_max(abs(row - focus_row), abs(col - focus_col));
+            if (disabled || distance <= SIM_LOD_NEAR_CHUNK_RADIUS) {
+                chunk->tier = SIM_LOD_TIER_NEAR;
+            } else if (distance <= SIM_LOD_MID_CHUNK_RADIUS) {
+                chunk->tier = SIM_LOD_TIER_MID;
+            } else {
+                chunk->tier = SIM_LOD_TIER_FAR;
+            }
+
+            chunk->coarse_dt_s = 0;
+
+            switch (chunk->tier) {
+            case SIM_LOD_TIER_NEAR:
+                // NOTE: a chunk that just came into range catches up on what it built up while it was mid
+                chunk->dt_s = chunk->accumulated_s + sim_dt_s;
+                chunk->accumulated_s = 0;
+                break;
+            case SIM_LOD_TIER_MID:
+                // NOTE: staggered by chunk index so the mid chunks don't all step on the same tick
+                chunk->accumulated_s += sim_dt_s;
+                if ((lod->tick_index + idx) % SIM_LOD_MID_TICK_INTERVAL == 0) {
+                    chunk->dt_s = chunk->accumulated_s;
+                    chunk->accumulated_s = 0;
+                } else {
+                    chunk->dt_s = 0;
+                }
+                break;
+            default:
+                chunk->dt_s = 0;
+                chunk->accumulated_s += sim_dt_s;
+                if ((lod->tick_index + idx) % SIM_LOD_FAR_TICK_INTERVAL == 0) {
+                    chunk->coarse_dt_s = chunk->accumulated_s;
+                    chunk->accumulated_s = 0;
+                }
+                break;
+            }
+
+            lod->tier_counts[chunk->tier]++;
+        }
+    }
+
+    lod->tick_index++;
+}
+
+// What an entity at position steps this tick, 0 when it sits the tick out
+double sim_lod_dt_s(SimLod* lod, Vec2 position) {
+    return lod->chunks[sim_lod_chunk_index(position)].dt_s;
+}
+
+// What an entity at position runs its coarse far tier step over this tick, 0 when it has none to run
+double sim_lod_coarse_dt_s(SimLod* lod, Vec2 position) {
+    return lod->chunks[sim_lod_chunk_index(position)].coarse_dt_s;
+}
+
+Rect sim_lod_chunk_bounds(uint32 idx) {
+    uint32 row = idx / SIM_LOD_CHUNKS_WIDE;
+    uint32 col = idx % SIM_LOD_CHUNKS_WIDE;
+
+    Rect result;
+    result.x = (col + 0.5f) * SPAWN_CHUNK_DIMENSION - (DEFAULT_WORLD_WIDTH / 2.0f);
+    result.y = (DEFAULT_WORLD_HEIGHT / 2.0f) - (row + 0.5f) * SPAWN_CHUNK_DIMENSION;
+    result.w = SPAWN_CHUNK_DIMENSION;
+    result.h = SPAWN_CHUNK_DIMENSION;
+
+    return result;
+}
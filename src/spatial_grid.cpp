@@ -0,0 +1,371 @@
+#include "game.h"
+
+static int spatial_grid_cell_coord(float world_coord) {
+    int coord = (int)w_floorf(world_coord / SPATIAL_GRID_CELL_DIMENSION) + (SPATIAL_GRID_DIMENSION / 2);
+
+    if (coord < 0) {
+        coord = 0;
+    } else if (coord >= SPATIAL_GRID_DIMENSION) {
+        coord = SPATIAL_GRID_DIMENSION - 1;
+    }
+
+    return coord;
+}
+
+uint32 spatial_grid_cell_index(Vec2 position) {
+    return spatial_grid_cell_coord(position.y) * SPATIAL_GRID_DIMENSION + spatial_grid_cell_coord(position.x);
+}
+
+static void spatial_grid_link(SpatialGrid* grid, uint32 id, uint32 cell) {
+    uint32 head = grid->cell_heads[cell];
+
+    grid->next[id] = head;
+    grid->prev[id] = SPATIAL_GRID_NULL;
+    if (head != SPATIAL_GRID_NULL) {
+        grid->prev[head] = id;
+    }
+
+    grid->cell_heads[cell] = id;
+    grid->cells[id] = cell;
+}
+
+static void spatial_grid_unlink(SpatialGrid* grid, uint32 id) {
+    uint32 cell = grid->cells[id];
+    uint32 prev = grid->prev[id];
+    uint32 next = grid->next[id];
+
+    if (prev != SPATIAL_GRID_NULL) {
+        grid->next[prev] = next;
+    } else {
+        grid->cell_heads[cell] = next;
+    }
+
+    if (next != SPATIAL_GRID_NULL) {
+        grid->prev[next] = prev;
+    }
+
+    grid->cells[id] = SPATIAL_GRID_NULL;
+}
+
+// NOTE: only the cell heads are reset, ids are cleared as the entity store grows with spatial_grid_clear_ids
+void spatial_grid_clear(SpatialGrid* grid) {
+    memset(grid->cell_heads, 0xFF, sizeof(grid->cell_heads));
+    grid->max_reach = 0;
+}
+
+void spatial_grid_clear_ids(SpatialGrid* grid, uint32 first_id, uint32 count) {
+    memset(&grid->cells[first_id], 0xFF, count * sizeof(uint32));
+}
+
+void spatial_grid_insert(SpatialGrid* grid, uint32 id, Vec2 position, float reach) {
+    ASSERT(grid->cells[id] == SPATIAL_GRID_NULL, "id has already been inserted into the spatial grid");
+
+    spatial_grid_link(grid, id, spatial_grid_cell_index(position));
+    grid->max_reach = w_max(grid->max_reach, reach);
+}
+
+void spatial_grid_remove(SpatialGrid* grid, uint32 id) {
+    if (grid->cells[id] != SPATIAL_GRID_NULL) {
+        spatial_grid_unlink(grid, id);
+    }
+}
+
+void spatial_grid_move(SpatialGrid* grid, uint32 id, Vec2 position) {
+    ASSERT(grid->cells[id] != SPATIAL_GRID_NULL, "id must be inserted into the spatial grid before moving");
+
+    uint32 cell = spatial_grid_cell_index(position);
+    if (grid->cells[id] != cell) {
+        spatial_grid_unlink(grid, id);
+        spatial_grid_link(grid, id, cell);
+    }
+}
+
+// Walks the cells of [min, max] widened by the largest reach inserted so far, bodies are bucketed by their position
+// so one overlapping the box can sit in a cell just outside it
+SpatialGridIterator spatial_grid_iterator(SpatialGrid* grid, Vec2 min, Vec2 max) {
+    SpatialGridIterator it = {};
+    it.min_col = spatial_grid_cell_coord(min.x - grid->max_reach);
+    it.max_col = spatial_grid_cell_coord(max.x + grid->max_reach);
+    it.max_row = spatial_grid_cell_coord(max.y + grid->max_reach);
+    it.row = spatial_grid_cell_coord(min.y - grid->max_reach);
+    it.col = it.min_col;
+    it.id = grid->cell_heads[it.row * SPATIAL_GRID_DIMENSION + it.col];
+
+    return it;
+}
+
+bool spatial_grid_iterator_next(SpatialGrid* grid, SpatialGridIterator* it, uint32* id) {
+    while (it->id == SPATIAL_GRID_NULL) {
+        it->col++;
+        if (it->col > it->max_col) {
+            it->col = it->min_col;
+            it->row++;
+        }
+
+        if (it->row > it->max_row) {
+            return false;
+        }
+
+        it->id = grid->cell_heads[it->row * SPATIAL_GRID_DIMENSION + it->col];
+    }
+
+    *id = it->id;
+    it->id = grid->next[it->id];
+
+    return true;
+}
+
+uint32 spatial_grid_query(SpatialGrid* grid, Vec2 min, Vec2 max, uint32* ids, uint32 max_ids) {
+    uint32 count = 0;
+    uint32 id;
+
+    SpatialGridIterator it = spatial_grid_iterator(grid, min, max);
+    while (spatial_grid_iterator_next(grid, &it, &id)) {
+        ASSERT(count < max_ids, "spatial grid query exceeded max_ids");
+        ids[count++] = id;
+    }
+
+    return count;
+}
+
+static void spatial_grid_ray_axis(float origin, float delta, double* t_next, double* t_step) {
+    if (delta == 0) {
+        *t_next = 2.0;
+        *t_step = 0;
+        return;
+    }
+
+    float cell = w_floorf(origin / SPATIAL_GRID_CELL_DIMENSION);
+    float boundary = (delta > 0 ? cell + 1 : cell) * SPATIAL_GRID_CELL_DIMENSION;
+    *t_next = (boundary - origin) / (double)delta;
+    *t_step = SPATIAL_GRID_CELL_DIMENSION / (double)w_abs(delta);
+}
+
+// NOTE: walks the cells of the unclamped grid, so a segment outside of the world still steps cell by cell
+SpatialGridRay spatial_grid_ray(Vec2 origin, Vec2 delta) {
+    SpatialGridRay ray = {};
+    spatial_grid_ray_axis(origin.x, delta.x, &ray.t_next_x, &ray.t_step_x);
+    spatial_grid_ray_axis(origin.y, delta.y, &ray.t_next_y, &ray.t_step_y);
+
+    return ray;
+}
+
+// Returns the next [t_start, t_end] piece of the segment that lies within a single cell, in order along the segment
+bool spatial_grid_ray_next(SpatialGridRay* ray, double* t_start, double* t_end) {
+    if (ray->done) {
+        return false;
+    }
+
+    *t_start = ray->t;
+
+    double t_next;
+    if (ray->t_next_x < ray->t_next_y) {
+        t_next = ray->t_next_x;
+        ray->t_next_x += ray->t_step_x;
+    } else {
+        t_next = ray->t_next_y;
+        ray->t_next_y += ray->t_step_y;
+    }
+
+    if (t_next >= 1.0) {
+        *t_end = 1.0;
+        ray->done = true;
+    } else {
+        *t_end = t_next;
+        ray->t = t_next;
+    }
+
+    return true;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~ static grid ~~~~~~~~~~~~~~~~~~~~~~~~ //
+
+static int static_grid_cell_coord(float world_coord) {
+    int coord = (int)w_floorf(world_coord / STATIC_GRID_CELL_DIMENSION) + (STATIC_GRID_DIMENSION / 2);
+
+    if (coord < 0) {
+        coord = 0;
+    } else if (coord >= STATIC_GRID_DIMENSION) {
+        coord = STATIC_GRID_DIMENSION - 1;
+    }
+
+    return coord;
+}
+
+static uint32 static_grid_chunk_index(int row, int col) {
+    return (row / STATIC_GRID_CHUNK_CELLS_WIDE) * STATIC_GRID_CHUNKS_WIDE + (col / STATIC_GRID_CHUNK_CELLS_WIDE);
+}
+
+static uint32 static_grid_local_cell(int row, int col) {
+    return (row % STATIC_GRID_CHUNK_CELLS_WIDE) * STATIC_GRID_CHUNK_CELLS_WIDE + (col % STATIC_GRID_CHUNK_CELLS_WIDE);
+}
+
+void static_grid_clear(StaticGrid* grid) {
+    for (int i = 0; i < STATIC_GRID_CHUNK_COUNT; i++) {
+        grid->chunks[i].count = 0;
+        grid->chunks[i].dirty = true;
+    }
+
+    grid->max_reach = 0;
+    grid->count = 0;
+}
+
+void static_grid_clear_ids(StaticGrid* grid, uint32 first_id, uint32 count) {
+    memset(&grid->chunk_of[first_id], 0xFF, count * sizeof(uint32));
+}
+
+// Whether a body for each of positions still fits, several of them can land in the same chunk
+bool static_grid_has_room(StaticGrid* grid, Vec2* positions, uint32 count) {
+    uint32 needed[STATIC_GRID_CHUNK_COUNT] = {};
+
+    for (int i = 0; i < count; i++) {
+        uint32 chunk_idx =
+            static_grid_chunk_index(static_grid_cell_coord(positions[i].y), static_grid_cell_coord(positions[i].x));
+        if (grid->chunks[chunk_idx].count + ++needed[chunk_idx] > STATIC_GRID_MAX_PER_CHUNK) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// NOTE: callers check static_grid_has_room first, the chunk's arrays have a fixed size
+void static_grid_insert(StaticGrid* grid, uint32 id, Vec2 position, float reach) {
+    ASSERT(grid->chunk_of[id] == SPATIAL_GRID_NULL, "id has already been inserted into the static grid");
+
+    uint32 chunk_idx = static_grid_chunk_index(static_grid_cell_coord(position.y), static_grid_cell_coord(position.x));
+    StaticGridChunk* chunk = &grid->chunks[chunk_idx];
+    ASSERT(chunk->count < STATIC_GRID_MAX_PER_CHUNK, "STATIC_GRID_MAX_PER_CHUNK has been reached!");
+
+    grid->chunk_of[id] = chunk_idx;
+    grid->slot_of[id] = chunk->count;
+    chunk->ids[chunk->count++] = id;
+    chunk->dirty = true;
+
+    grid->max_reach = w_max(grid->max_reach, reach);
+    grid->count++;
+}
+
+void static_grid_remove(StaticGrid* grid, uint32 id) {
+    if (grid->chunk_of[id] == SPATIAL_GRID_NULL) {
+        return;
+    }
+
+    StaticGridChunk* chunk = &grid->chunks[grid->chunk_of[id]];
+    uint32 slot = grid->slot_of[id];
+    uint32 last_id = chunk->ids[--chunk->count];
+
+    chunk->ids[slot] = last_id;
+    grid->slot_of[last_id] = slot;
+    grid->chunk_of[id] = SPATIAL_GRID_NULL;
+    chunk->dirty = true;
+
+    grid->count--;
+}
+
+// Counting sort of the chunk's bodies into its cells, copying their bounds so queries read them contiguously
+static void static_grid_rebuild_chunk(StaticGrid* grid, StaticGridChunk* chunk, EntityData* entity_data) {
+    uint32 cursors[STATIC_GRID_CHUNK_CELL_COUNT];
+    memset(chunk->cell_start, 0, sizeof(chunk->cell_start));
+
+    for (int i = 0; i < chunk->count; i++) {
+        Entity* entity = &entity_data->entities[entity_data->entity_lookups[chunk->ids[i]].idx];
+        uint32 cell = static_grid_local_cell(static_grid_cell_coord(entity->position.y),
+                                             static_grid_cell_coord(entity->position.x));
+        chunk->cell_start[cell + 1]++;
+    }
+
+    for (int i = 0; i < STATIC_GRID_CHUNK_CELL_COUNT; i++) {
+        chunk->cell_start[i + 1] += chunk->cell_start[i];
+        cursors[i] = chunk->cell_start[i];
+    }
+
+    for (int i = 0; i < chunk->count; i++) {
+        uint32 id = chunk->ids[i];
+        uint32 idx = entity_data->entity_lookups[id].idx;
+        Entity* entity = &entity_data->entities[idx];
+        uint32 cell = static_grid_local_cell(static_grid_cell_coord(entity->position.y),
+                                             static_grid_cell_coord(entity->position.x));
+
+        uint32 slot = cursors[cell]++;
+        chunk->sorted_ids[slot] = id;
+        chunk->min_x[slot] = entity_data->bounds.min_x[idx];
+        chunk->min_y[slot] = entity_data->bounds.min_y[idx];
+        chunk->max_x[slot] = entity_data->bounds.max_x[idx];
+        chunk->max_y[slot] = entity_data->bounds.max_y[idx];
+    }
+
+    chunk->dirty = false;
+    grid->rebuilds++;
+}
+
+// Queries rebuild the dirty chunks they visit, after this they only read the grid so jobs can run them in parallel
+void static_grid_rebuild_dirty(StaticGrid* grid, EntityData* entity_data) {
+    for (int i = 0; i < STATIC_GRID_CHUNK_COUNT; i++) {
+        if (grid->chunks[i].dirty) {
+            static_grid_rebuild_chunk(grid, &grid->chunks[i], entity_data);
+        }
+    }
+}
+
+// Walks the static cells of [min, max] widened by the largest static reach, chunk by chunk. A dirty chunk is rebuilt
+// when the walk enters it.
+StaticGridIterator static_grid_iterator(StaticGrid* grid, Vec2 min, Vec2 max) {
+    StaticGridIterator it = {};
+    it.min_col = static_grid_cell_coord(min.x - grid->max_reach);
+    it.max_col = static_grid_cell_coord(max.x + grid->max_reach);
+    it.max_row = static_grid_cell_coord(max.y + grid->max_reach);
+    it.row = static_grid_cell_coord(min.y - grid->max_reach);
+    it.col = it.min_col - 1;
+
+    return it;
+}
+
+// Returns the id of the next body, its bounds are at it->at - 1 in it->chunk
+bool static_grid_iterator_next(StaticGrid* grid, EntityData* entity_data, StaticGridIterator* it, uint32* id) {
+    while (it->at == it->end) {
+        it->col++;
+        if (it->col > it->max_col) {
+            it->col = it->min_col;
+            it->row++;
+        }
+
+        if (it->row > it->max_row) {
+            return false;
+        }
+
+        StaticGridChunk* chunk = &grid->chunks[static_grid_chunk_index(it->row, it->col)];
+        if (chunk->dirty) {
+            static_grid_rebuild_chunk(grid, chunk, entity_data);
+        }
+
+        uint32 cell = static_grid_local_cell(it->row, it->col);
+        it->chunk = chunk;
+        it->at = chunk->cell_start[cell];
+        it->end = chunk->cell_start[cell + 1];
+    }
+
+    *id = it->chunk->sorted_ids[it->at++];
+
+    return true;
+}
+
+// Returns the ids of static bodies whose bounds overlap [min, max]
+uint32 static_grid_query_overlapping(StaticGrid* grid, EntityData* entity_data, Vec2 min, Vec2 max, uint32* ids,
+                                     uint32 max_ids) {
+    uint32 count = 0;
+    uint32 id;
+
+    StaticGridIterator it = static_grid_iterator(grid, min, max);
+    while (static_grid_iterator_next(grid, entity_data, &it, &id)) {
+        uint32 slot = it.at - 1;
+        StaticGridChunk* chunk = it.chunk;
+        if (chunk->min_x[slot] <= max.x && chunk->max_x[slot] >= min.x && chunk->min_y[slot] <= max.y &&
+            chunk->max_y[slot] >= min.y) {
+            ASSERT(count < max_ids, "static grid query exceeded max_ids");
+            ids[count++] = id;
+        }
+    }
+
+    return count;
+}
@@ -10,6 +10,26 @@
 #include "math.h"
 #include "asset_ids.h"
 
+#ifdef _WIN32
+#include <intrin.h>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define W_SIMD_AVX2
+#define W_SIMD_NAME "AVX2"
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define W_SIMD_SSE2
+#define W_SIMD_NAME "SSE2"
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define W_SIMD_NEON
+#define W_SIMD_NAME "NEON"
+#else
+#define W_SIMD_NAME "scalar"
+#endif
+
 #define STB_PERLIN_IMPLEMENTATION
 #include "stb_perlin.h"
 
@@ -549,13 +569,14 @@ bool w_test_wall_collision(float start_x, float start_y, float delta_x, float de
     return false;
 }
 
-void w_rect_collision(Rect subject, Vec2 subject_delta, Rect target, Vec2 target_delta, double* t_collision,
-                      Vec2* collision_normal) {
+// Same as w_rect_collision with the target given as min/max bounds
+void w_aabb_collision(Rect subject, Vec2 subject_delta, float target_min_x, float target_min_y, float target_max_x,
+                      float target_max_y, Vec2 target_delta, double* t_collision, Vec2* collision_normal) {
     // Uses minkowski sums
-    float wall_top_y = target.y + (target.h / 2) + (subject.h / 2);
-    float wall_bottom_y = target.y - (target.h / 2) - (subject.h / 2);
-    float wall_left_x = target.x - (target.w / 2) - (subject.w / 2);
-    float wall_right_x = target.x + (target.w / 2) + (subject.w / 2);
+    float wall_top_y = target_max_y + (subject.h / 2);
+    float wall_bottom_y = target_min_y - (subject.h / 2);
+    float wall_left_x = target_min_x - (subject.w / 2);
+    float wall_right_x = target_max_x + (subject.w / 2);
     Vec2 start_pos = {subject.x, subject.y};
     Vec2 rel_delta = w_vec_sub(subject_delta, target_delta);
 
@@ -577,6 +598,258 @@ void w_rect_collision(Rect subject, Vec2 subject_delta, Rect target, Vec2 target
     }
 }
 
+void w_rect_collision(Rect subject, Vec2 subject_delta, Rect target, Vec2 target_delta, double* t_collision,
+                      Vec2* collision_normal) {
+    w_aabb_collision(subject, subject_delta, target.x - (target.w / 2), target.y - (target.h / 2),
+                     target.x + (target.w / 2), target.y + (target.h / 2), target_delta, t_collision, collision_normal);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~ batched swept AABB ~~~~~~~~~~~~~~~~~~~~~~~~ //
+// The SIMD kernels do the same float math as w_test_wall_collision (including computing the collision coordinate in
+// double) to find which targets could lower t_collision. Only those targets are run through w_aabb_collision, in
+// order, so the result is bitwise identical to calling w_aabb_collision on every target.
+
+struct WAabbBatchSubject {
+    float start_x;
+    float start_y;
+    float half_w;
+    float half_h;
+    float delta_x;
+    float delta_y;
+    float t_limit; // smallest float >= t_collision
+};
+
+#if defined(W_SIMD_AVX2)
+#define W_AABB_BATCH_WIDTH 8
+
+// (float)((double)a * (double)b + (double)c), the product of two floats is exact in double so this also holds if the
+// compiler contracts it into an fma
+static inline __m256 w_simd_mul_add_f64(__m256 a, __m256 b, __m256 c) {
+    __m256d lo = _mm256_add_pd(_mm256_mul_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(a)),
+                                             _mm256_cvtps_pd(_mm256_castps256_ps128(b))),
+                               _mm256_cvtps_pd(_mm256_castps256_ps128(c)));
+    __m256d hi = _mm256_add_pd(_mm256_mul_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(a, 1)),
+                                             _mm256_cvtps_pd(_mm256_extractf128_ps(b, 1))),
+                               _mm256_cvtps_pd(_mm256_extractf128_ps(c, 1)));
+
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(lo)), _mm256_cvtpd_ps(hi), 1);
+}
+
+static inline __m256 w_simd_wall_hit(__m256 wall, __m256 start, __m256 delta, __m256 other_start, __m256 other_delta,
+                                     __m256 wall_min, __m256 wall_max, __m256 t_limit) {
+    __m256 zero = _mm256_setzero_ps();
+    __m256 t = _mm256_div_ps(_mm256_sub_ps(wall, start), delta);
+    __m256 collision = w_simd_mul_add_f64(other_delta, t, other_start);
+
+    __m256 hit = _mm256_cmp_ps(delta, zero, _CMP_NEQ_UQ);
+    hit = _mm256_and_ps(hit, _mm256_cmp_ps(t, zero, _CMP_GE_OQ));
+    hit = _mm256_and_ps(hit, _mm256_cmp_ps(t, t_limit, _CMP_LE_OQ));
+    hit = _mm256_and_ps(hit, _mm256_cmp_ps(collision, wall_max, _CMP_LE_OQ));
+    hit = _mm256_and_ps(hit, _mm256_cmp_ps(collision, wall_min, _CMP_GE_OQ));
+
+    return hit;
+}
+
+static uint32 w_aabb_batch_candidates(WAabbBatchSubject* subject, float* min_x, float* min_y, float* max_x,
+                                      float* max_y, float* delta_x, float* delta_y) {
+    __m256 start_x = _mm256_set1_ps(subject->start_x);
+    __m256 start_y = _mm256_set1_ps(subject->start_y);
+    __m256 half_w = _mm256_set1_ps(subject->half_w);
+    __m256 half_h = _mm256_set1_ps(subject->half_h);
+    __m256 t_limit = _mm256_set1_ps(subject->t_limit);
+
+    __m256 rel_delta_x = _mm256_sub_ps(_mm256_set1_ps(subject->delta_x), _mm256_loadu_ps(delta_x));
+    __m256 rel_delta_y = _mm256_sub_ps(_mm256_set1_ps(subject->delta_y), _mm256_loadu_ps(delta_y));
+
+    __m256 wall_top_y = _mm256_add_ps(_mm256_loadu_ps(max_y), half_h);
+    __m256 wall_bottom_y = _mm256_sub_ps(_mm256_loadu_ps(min_y), half_h);
+    __m256 wall_left_x = _mm256_sub_ps(_mm256_loadu_ps(min_x), half_w);
+    __m256 wall_right_x = _mm256_add_ps(_mm256_loadu_ps(max_x), half_w);
+
+    __m256 hit = w_simd_wall_hit(wall_left_x, start_x, rel_delta_x, start_y, rel_delta_y, wall_bottom_y, wall_top_y,
+                                 t_limit);
+    hit = _mm256_or_ps(hit, w_simd_wall_hit(wall_right_x, start_x, rel_delta_x, start_y, rel_delta_y, wall_bottom_y,
+                                            wall_top_y, t_limit));
+    hit = _mm256_or_ps(hit, w_simd_wall_hit(wall_top_y, start_y, rel_delta_y, start_x, rel_delta_x, wall_left_x,
+                                            wall_right_x, t_limit));
+    hit = _mm256_or_ps(hit, w_simd_wall_hit(wall_bottom_y, start_y, rel_delta_y, start_x, rel_delta_x, wall_left_x,
+                                            wall_right_x, t_limit));
+
+    return (uint32)_mm256_movemask_ps(hit);
+}
+#elif defined(W_SIMD_SSE2)
+#define W_AABB_BATCH_WIDTH 4
+
+// (float)((double)a * (double)b + (double)c), the product of two floats is exact in double so this also holds if the
+// compiler contracts it into an fma
+static inline __m128 w_simd_mul_add_f64(__m128 a, __m128 b, __m128 c) {
+    __m128d lo = _mm_add_pd(_mm_mul_pd(_mm_cvtps_pd(a), _mm_cvtps_pd(b)), _mm_cvtps_pd(c));
+    __m128d hi = _mm_add_pd(_mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(a, a)), _mm_cvtps_pd(_mm_movehl_ps(b, b))),
+                            _mm_cvtps_pd(_mm_movehl_ps(c, c)));
+
+    return _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+}
+
+static inline __m128 w_simd_wall_hit(__m128 wall, __m128 start, __m128 delta, __m128 other_start, __m128 other_delta,
+                                     __m128 wall_min, __m128 wall_max, __m128 t_limit) {
+    __m128 zero = _mm_setzero_ps();
+    __m128 t = _mm_div_ps(_mm_sub_ps(wall, start), delta);
+    __m128 collision = w_simd_mul_add_f64(other_delta, t, other_start);
+
+    __m128 hit = _mm_cmpneq_ps(delta, zero);
+    hit = _mm_and_ps(hit, _mm_cmpge_ps(t, zero));
+    hit = _mm_and_ps(hit, _mm_cmple_ps(t, t_limit));
+    hit = _mm_and_ps(hit, _mm_cmple_ps(collision, wall_max));
+    hit = _mm_and_ps(hit, _mm_cmpge_ps(collision, wall_min));
+
+    return hit;
+}
+
+static uint32 w_aabb_batch_candidates(WAabbBatchSubject* subject, float* min_x, float* min_y, float* max_x,
+                                      float* max_y, float* delta_x, float* delta_y) {
+    __m128 start_x = _mm_set1_ps(subject->start_x);
+    __m128 start_y = _mm_set1_ps(subject->start_y);
+    __m128 half_w = _mm_set1_ps(subject->half_w);
+    __m128 half_h = _mm_set1_ps(subject->half_h);
+    __m128 t_limit = _mm_set1_ps(subject->t_limit);
+
+    __m128 rel_delta_x = _mm_sub_ps(_mm_set1_ps(subject->delta_x), _mm_loadu_ps(delta_x));
+    __m128 rel_delta_y = _mm_sub_ps(_mm_set1_ps(subject->delta_y), _mm_loadu_ps(delta_y));
+
+    __m128 wall_top_y = _mm_add_ps(_mm_loadu_ps(max_y), half_h);
+    __m128 wall_bottom_y = _mm_sub_ps(_mm_loadu_ps(min_y), half_h);
+    __m128 wall_left_x = _mm_sub_ps(_mm_loadu_ps(min_x), half_w);
+    __m128 wall_right_x = _mm_add_ps(_mm_loadu_ps(max_x), half_w);
+
+    __m128 hit = w_simd_wall_hit(wall_left_x, start_x, rel_delta_x, start_y, rel_delta_y, wall_bottom_y, wall_top_y,
+                                 t_limit);
+    hit = _mm_or_ps(hit, w_simd_wall_hit(wall_right_x, start_x, rel_delta_x, start_y, rel_delta_y, wall_bottom_y,
+                                         wall_top_y, t_limit));
+    hit = _mm_or_ps(hit, w_simd_wall_hit(wall_top_y, start_y, rel_delta_y, start_x, rel_delta_x, wall_left_x,
+                                         wall_right_x, t_limit));
+    hit = _mm_or_ps(hit, w_simd_wall_hit(wall_bottom_y, start_y, rel_delta_y, start_x, rel_delta_x, wall_left_x,
+                                         wall_right_x, t_limit));
+
+    return (uint32)_mm_movemask_ps(hit);
+}
+#elif defined(W_SIMD_NEON)
+#define W_AABB_BATCH_WIDTH 4
+
+// (float)((double)a * (double)b + (double)c), the product of two floats is exact in double so this also holds if the
+// compiler contracts it into an fma
+static inline float32x4_t w_simd_mul_add_f64(float32x4_t a, float32x4_t b, float32x4_t c) {
+    float64x2_t lo = vaddq_f64(vmulq_f64(vcvt_f64_f32(vget_low_f32(a)), vcvt_f64_f32(vget_low_f32(b))),
+                               vcvt_f64_f32(vget_low_f32(c)));
+    float64x2_t hi = vaddq_f64(vmulq_f64(vcvt_high_f64_f32(a), vcvt_high_f64_f32(b)), vcvt_high_f64_f32(c));
+
+    return vcvt_high_f32_f64(vcvt_f32_f64(lo), hi);
+}
+
+static inline uint32x4_t w_simd_wall_hit(float32x4_t wall, float32x4_t start, float32x4_t delta,
+                                         float32x4_t other_start, float32x4_t other_delta, float32x4_t wall_min,
+                                         float32x4_t wall_max, float32x4_t t_limit) {
+    float32x4_t zero = vdupq_n_f32(0);
+    float32x4_t t = vdivq_f32(vsubq_f32(wall, start), delta);
+    float32x4_t collision = w_simd_mul_add_f64(other_delta, t, other_start);
+
+    uint32x4_t hit = vmvnq_u32(vceqq_f32(delta, zero));
+    hit = vandq_u32(hit, vcgeq_f32(t, zero));
+    hit = vandq_u32(hit, vcleq_f32(t, t_limit));
+    hit = vandq_u32(hit, vcleq_f32(collision, wall_max));
+    hit = vandq_u32(hit, vcgeq_f32(collision, wall_min));
+
+    return hit;
+}
+
+static uint32 w_aabb_batch_candidates(WAabbBatchSubject* subject, float* min_x, float* min_y, float* max_x,
+                                      float* max_y, float* delta_x, float* delta_y) {
+    float32x4_t start_x = vdupq_n_f32(subject->start_x);
+    float32x4_t start_y = vdupq_n_f32(subject->start_y);
+    float32x4_t half_w = vdupq_n_f32(subject->half_w);
+    float32x4_t half_h = vdupq_n_f32(subject->half_h);
+    float32x4_t t_limit = vdupq_n_f32(subject->t_limit);
+
+    float32x4_t rel_delta_x = vsubq_f32(vdupq_n_f32(subject->delta_x), vld1q_f32(delta_x));
+    float32x4_t rel_delta_y = vsubq_f32(vdupq_n_f32(subject->delta_y), vld1q_f32(delta_y));
+
+    float32x4_t wall_top_y = vaddq_f32(vld1q_f32(max_y), half_h);
+    float32x4_t wall_bottom_y = vsubq_f32(vld1q_f32(min_y), half_h);
+    float32x4_t wall_left_x = vsubq_f32(vld1q_f32(min_x), half_w);
+    float32x4_t wall_right_x = vaddq_f32(vld1q_f32(max_x), half_w);
+
+    uint32x4_t hit = w_simd_wall_hit(wall_left_x, start_x, rel_delta_x, start_y, rel_delta_y, wall_bottom_y,
+                                     wall_top_y, t_limit);
+    hit = vorrq_u32(hit, w_simd_wall_hit(wall_right_x, start_x, rel_delta_x, start_y, rel_delta_y, wall_bottom_y,
+                                         wall_top_y, t_limit));
+    hit = vorrq_u32(hit, w_simd_wall_hit(wall_top_y, start_y, rel_delta_y, start_x, rel_delta_x, wall_left_x,
+                                         wall_right_x, t_limit));
+    hit = vorrq_u32(hit, w_simd_wall_hit(wall_bottom_y, start_y, rel_delta_y, start_x, rel_delta_x, wall_left_x,
+                                         wall_right_x, t_limit));
+
+    uint32x4_t lane_bits = {1, 2, 4, 8};
+    return vaddvq_u32(vandq_u32(hit, lane_bits));
+}
+#endif
+
+static float w_aabb_batch_t_limit(double t_collision) {
+    float t_limit = (float)t_collision;
+    if ((double)t_limit < t_collision) {
+        t_limit = nextafterf(t_limit, INFINITY);
+    }
+
+    return t_limit;
+}
+
+// Tests subject against count targets given as SoA bounds and deltas. Same as calling w_aabb_collision on each target
+// in order, returns the index of the last target that lowered t_collision or -1 if none did.
+int w_aabb_collision_batch(Rect subject, Vec2 subject_delta, float* min_x, float* min_y, float* max_x, float* max_y,
+                           float* delta_x, float* delta_y, uint32 count, double* t_collision,
+                           Vec2* collision_normal) {
+    int hit_idx = -1;
+    uint32 i = 0;
+
+#ifdef W_AABB_BATCH_WIDTH
+    WAabbBatchSubject batch_subject = {.start_x = subject.x,
+                                       .start_y = subject.y,
+                                       .half_w = subject.w / 2,
+                                       .half_h = subject.h / 2,
+                                       .delta_x = subject_delta.x,
+                                       .delta_y = subject_delta.y,
+                                       .t_limit = w_aabb_batch_t_limit(*t_collision)};
+
+    for (; i + W_AABB_BATCH_WIDTH <= count; i += W_AABB_BATCH_WIDTH) {
+        uint32 candidates = w_aabb_batch_candidates(&batch_subject, &min_x[i], &min_y[i], &max_x[i], &max_y[i],
+                                                    &delta_x[i], &delta_y[i]);
+
+        for (uint32 lane = 0; candidates; lane++, candidates >>= 1) {
+            if (candidates & 1) {
+                uint32 j = i + lane;
+                double prev_t_collision = *t_collision;
+                w_aabb_collision(subject, subject_delta, min_x[j], min_y[j], max_x[j], max_y[j],
+                                 {delta_x[j], delta_y[j]}, t_collision, collision_normal);
+
+                if (*t_collision != prev_t_collision) {
+                    hit_idx = j;
+                    batch_subject.t_limit = w_aabb_batch_t_limit(*t_collision);
+                }
+            }
+        }
+    }
+#endif
+
+    for (; i < count; i++) {
+        double prev_t_collision = *t_collision;
+        w_aabb_collision(subject, subject_delta, min_x[i], min_y[i], max_x[i], max_y[i], {delta_x[i], delta_y[i]},
+                         t_collision, collision_normal);
+
+        if (*t_collision != prev_t_collision) {
+            hit_idx = i;
+        }
+    }
+
+    return hit_idx;
+}
+
 Vec2 w_rotate_around_pivot(Vec2 position, Vec2 pivot, float radians) {
     // here, we are basically creating a new coordinate system as if we rotated the x and y axis by theta. We then scale
     // our new axis by the entities position which gets the new position relative to the pivot.
@@ -754,9 +1027,9 @@ void w_timestamp_str(char* timestamp_str, int size) {
     strftime(timestamp_str, size, "%Y%m%d_%H%M%S", t);
 }
 
-static Animation* i_animation_table;
+static const Animation* i_animation_table;
 
-void w_init_animation(Animation* animation_table) {
+void w_init_animation(const Animation* animation_table) {
     i_animation_table = animation_table;
 }
 
@@ -815,6 +1088,44 @@ void w_play_animation(AnimationID animation_id, AnimationState* anim_state, flag
 void w_play_animation(AnimationID animation_id, AnimationState* anim_state) {
     w_play_animation(animation_id, anim_state, 0);
 }
+// ~~~~~~~~~~~~~~~~~~~~~~~ Atomics ~~~~~~~~~~~~~~~~~~~~~~~~ //
+
+// Sequentially consistent read-modify-writes, each returns the value from before the operation
+
+#ifdef _WIN32
+uint32 w_atomic_add_u32(volatile uint32* value, uint32 addend) {
+    return (uint32)_InterlockedExchangeAdd((volatile long*)value, (long)addend);
+}
+
+int32 w_atomic_add_i32(volatile int32* value, int32 addend) {
+    return (int32)_InterlockedExchangeAdd((volatile long*)value, (long)addend);
+}
+
+uint8 w_atomic_or_u8(volatile uint8* value, uint8 bits) {
+    return (uint8)_InterlockedOr8((volatile char*)value, (char)bits);
+}
+
+int32 w_atomic_load_i32(volatile int32* value) {
+    return (int32)_InterlockedOr((volatile long*)value, 0);
+}
+#else
+uint32 w_atomic_add_u32(volatile uint32* value, uint32 addend) {
+    return __atomic_fetch_add(value, addend, __ATOMIC_SEQ_CST);
+}
+
+int32 w_atomic_add_i32(volatile int32* value, int32 addend) {
+    return __atomic_fetch_add(value, addend, __ATOMIC_SEQ_CST);
+}
+
+uint8 w_atomic_or_u8(volatile uint8* value, uint8 bits) {
+    return __atomic_fetch_or(value, bits, __ATOMIC_SEQ_CST);
+}
+
+int32 w_atomic_load_i32(volatile int32* value) {
+    return __atomic_load_n(value, __ATOMIC_SEQ_CST);
+}
+#endif
+
 // ~~~~~~~~~~~~~~~~~~~~ XorShift Rand ~~~~~~~~~~~~~~~~~~~~~ //
 
 struct XorShift32Context {
@@ -877,6 +1188,80 @@ int w_rng_range_i32(uint32* rng, int min, int max) {
     return min + (int)(w_rng_u32(rng) % (uint32)(max - min + 1));
 }
 
+// Checks w_aabb_collision_batch against w_rect_collision run on every target for random cases, including shared
+// walls, touching rects and zero deltas. Returns false at the first case they disagree on, which path was checked
+// depends on the SIMD width the code was built for, see W_SIMD_NAME.
+bool w_check_aabb_collision_batch() {
+    const int max_targets = 19;
+    Rect targets[max_targets];
+    Vec2 target_deltas[max_targets];
+    float min_x[max_targets], min_y[max_targets], max_x[max_targets], max_y[max_targets];
+    float delta_x[max_targets], delta_y[max_targets];
+
+    uint32 rng = 0x2545f491;
+    for (int test = 0; test < 20000; test++) {
+        Rect subject = {w_rng_range_f32(&rng, -4, 4), w_rng_range_f32(&rng, -4, 4), w_rng_range_f32(&rng, 0, 2),
+                        w_rng_range_f32(&rng, 0, 2)};
+        Vec2 subject_delta = {w_rng_range_f32(&rng, -6, 6), w_rng_range_f32(&rng, -6, 6)};
+        if (w_rng_range_i32(&rng, 0, 4) == 0) {
+            subject_delta.x = 0;
+        }
+        if (w_rng_range_i32(&rng, 0, 4) == 0) {
+            subject_delta.y = 0;
+        }
+
+        int count = w_rng_range_i32(&rng, 0, max_targets);
+        for (int i = 0; i < count; i++) {
+            if (i > 0 && w_rng_range_i32(&rng, 0, 5) == 0) {
+                targets[i] = targets[w_rng_range_i32(&rng, 0, i - 1)];
+                target_deltas[i] = target_deltas[i - 1];
+            } else if (w_rng_range_i32(&rng, 0, 5) == 0) {
+                // touching the subject on its right side
+                float w = w_rng_range_f32(&rng, 0, 2);
+                targets[i] = {subject.x + (subject.w / 2) + (w / 2), subject.y, w, w_rng_range_f32(&rng, 0, 2)};
+                target_deltas[i] = {};
+            } else {
+                targets[i] = {w_rng_range_f32(&rng, -6, 6), w_rng_range_f32(&rng, -6, 6), w_rng_range_f32(&rng, 0, 3),
+                              w_rng_range_f32(&rng, 0, 3)};
+                target_deltas[i] = {w_rng_range_f32(&rng, -1, 1), w_rng_range_f32(&rng, -1, 1)};
+            }
+
+            min_x[i] = targets[i].x - (targets[i].w / 2);
+            min_y[i] = targets[i].y - (targets[i].h / 2);
+            max_x[i] = targets[i].x + (targets[i].w / 2);
+            max_y[i] = targets[i].y + (targets[i].h / 2);
+            delta_x[i] = target_deltas[i].x;
+            delta_y[i] = target_deltas[i].y;
+        }
+
+        // NOTE: also start from a t that isn't representable as a float
+        double t_start = w_rng_range_i32(&rng, 0, 1) ? 1.0 : 0.7;
+
+        double expected_t = t_start;
+        Vec2 expected_normal = {};
+        int expected_idx = -1;
+        for (int i = 0; i < count; i++) {
+            double prev_t = expected_t;
+            w_rect_collision(subject, subject_delta, targets[i], target_deltas[i], &expected_t, &expected_normal);
+            if (expected_t != prev_t) {
+                expected_idx = i;
+            }
+        }
+
+        double t = t_start;
+        Vec2 normal = {};
+        int idx = w_aabb_collision_batch(subject, subject_delta, min_x, min_y, max_x, max_y, delta_x, delta_y, count,
+                                         &t, &normal);
+
+        if (memcmp(&t, &expected_t, sizeof(double)) != 0 || normal.x != expected_normal.x ||
+            normal.y != expected_normal.y || idx != expected_idx) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 struct FBMContext {
     uint32 octaves;
     float lacunarity; // Kind of affects how noisey or gappy the noise is